@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// cat() of 8 integers at a time, with integral_writer (cat(x)) versus branchless_integral_writer
+// (cat(branchless(x))), for three distributions of the values:
+//
+//   UniformRange   uniform over the whole range of the type (mostly of the longest lengths)
+//   UniformDigits  the number of digits, then the value, uniform (the length is unpredictable)
+//   FixedLength    4 digit values (the length is predictable)
+//
+// branchless() wins where the length mispredicts, and loses a little where it does not.
+
+constexpr size_t count = 4096;
+
+enum class distribution { uniform_range, uniform_digits, fixed_length };
+
+template <typename T>
+std::vector<T> random_values(distribution d) {
+    std::mt19937_64 rng(42);
+    std::vector<T> ret(count);
+    for (T& v : ret) {
+        switch (d) {
+            case distribution::uniform_range:
+                v = static_cast<T>(rng());
+                break;
+            case distribution::uniform_digits: {
+                std::uint64_t bound = 1;
+                const auto digits = 1 + rng() % std::numeric_limits<T>::digits10;
+                for (size_t i = 0; i != digits; ++i) bound *= 10;
+                v = static_cast<T>(rng() % bound);
+                if (rng() & 1) v = static_cast<T>(-v);
+                break;
+            }
+            case distribution::fixed_length:
+                v = static_cast<T>(1000 + rng() % 9000);
+                break;
+        }
+    }
+    return ret;
+}
+
+template <typename T, distribution D>
+void Integers_Cat(benchmark::State& state) {
+    const std::vector<T> v = random_values<T>(D);
+    for (auto _ : state) {
+        for (size_t i = 0; i != count; i += 8) {
+            std::string s = cat(v[i], v[i + 1], v[i + 2], v[i + 3], v[i + 4], v[i + 5], v[i + 6],
+                                v[i + 7]);
+            benchmark::DoNotOptimize(s);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+
+template <typename T, distribution D>
+void Integers_CatBranchless(benchmark::State& state) {
+    const std::vector<T> v = random_values<T>(D);
+    for (auto _ : state) {
+        for (size_t i = 0; i != count; i += 8) {
+            std::string s = cat(branchless(v[i]), branchless(v[i + 1]), branchless(v[i + 2]),
+                                branchless(v[i + 3]), branchless(v[i + 4]), branchless(v[i + 5]),
+                                branchless(v[i + 6]), branchless(v[i + 7]));
+            benchmark::DoNotOptimize(s);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+
+BENCHMARK(Integers_Cat<std::int32_t, distribution::uniform_range>);
+BENCHMARK(Integers_CatBranchless<std::int32_t, distribution::uniform_range>);
+BENCHMARK(Integers_Cat<std::int32_t, distribution::uniform_digits>);
+BENCHMARK(Integers_CatBranchless<std::int32_t, distribution::uniform_digits>);
+BENCHMARK(Integers_Cat<std::int32_t, distribution::fixed_length>);
+BENCHMARK(Integers_CatBranchless<std::int32_t, distribution::fixed_length>);
+BENCHMARK(Integers_Cat<std::int64_t, distribution::uniform_range>);
+BENCHMARK(Integers_CatBranchless<std::int64_t, distribution::uniform_range>);
+BENCHMARK(Integers_Cat<std::int64_t, distribution::uniform_digits>);
+BENCHMARK(Integers_CatBranchless<std::int64_t, distribution::uniform_digits>);
+BENCHMARK(Integers_Cat<std::int64_t, distribution::fixed_length>);
+BENCHMARK(Integers_CatBranchless<std::int64_t, distribution::fixed_length>);
+
+}  // namespace
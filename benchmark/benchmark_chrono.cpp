@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// Simulates a logger emitting many lines per second: the timestamp advances by 1us per line.
+class Timestamp_Fixture : public benchmark::Fixture {
+   public:
+    inline static std::string message;
+    void SetUp(const ::benchmark::State&) { message = "request handled status=200"; }
+
+    void TearDown(const ::benchmark::State&) { message.clear(); }
+};
+
+BENCHMARK_F(Timestamp_Fixture, Timestamp_Strftime)(benchmark::State& state) {
+    std::int64_t us = 1700000000000000;
+    for (auto _ : state) {
+        const std::time_t t = static_cast<std::time_t>(us / 1000000);
+        std::tm tm;
+#if defined(_WIN32)
+        gmtime_s(&tm, &t);
+#else
+        gmtime_r(&t, &tm);
+#endif
+        char buf[32];
+        const size_t len = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm);
+        char frac[8];
+        std::snprintf(frac, sizeof(frac), ".%06d", static_cast<int>(us % 1000000));
+        std::string total = cat(std::string_view(buf, len), frac, "Z ", message);
+        benchmark::DoNotOptimize(total);
+        ++us;
+    }
+}
+
+BENCHMARK_F(Timestamp_Fixture, Timestamp_LazyCat)(benchmark::State& state) {
+    std::int64_t us = 1700000000000000;
+    for (auto _ : state) {
+        const auto tp = std::chrono::sys_time<std::chrono::microseconds>{
+            std::chrono::microseconds{us}};
+        std::string total = cat(rfc3339_micros(tp), ' ', message);
+        benchmark::DoNotOptimize(total);
+        ++us;
+    }
+}
+
+BENCHMARK_F(Timestamp_Fixture, Timestamp_LazyCat_Cached)(benchmark::State& state) {
+    std::int64_t us = 1700000000000000;
+    for (auto _ : state) {
+        const auto tp = std::chrono::sys_time<std::chrono::microseconds>{
+            std::chrono::microseconds{us}};
+        std::string total = cat(cached_rfc3339_micros(tp), ' ', message);
+        benchmark::DoNotOptimize(total);
+        ++us;
+    }
+}
+
+}  // namespace
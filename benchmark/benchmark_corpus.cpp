@@ -0,0 +1,242 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_scan.hpp>
+
+#include "benchmark_libraries.hpp"
+#include "instrumentation_counters.hpp"
+#include "perf_counters.hpp"
+
+// Replays a corpus of log records through each library: every record becomes one string, built
+// from the template of its kind.  The default corpus is benchmark/corpus/log_records.tsv, made by
+// make_corpus.py; set the LAZYCAT_BENCHMARK_CORPUS environment variable to replay another file in
+// the same format (one record per line, its kind and its fields separated by tabs):
+//
+//   http    client_ip method path status bytes duration_ms
+//           -> "10.0.0.1 - GET /api/v1/users 200 5120 1.25ms"
+//   kv      level component user_id retries message
+//           -> "level=INFO component=db user_id=123456 retries=0 msg=\"query returned\""
+//   metric  name host value timestamp_ms
+//           -> "cpu.load,host=web-01 value=0.75 1700000000000"
+//   trade   order_id side quantity symbol price
+//           -> "order 1234567890 BUY 100 AAPL @ 187.25"
+//
+// The records are replayed in file order, so kinds and value shapes interleave as in a real log.
+// Corpus_Replay<Lib> reports the time per record (per_record), bytes/s, and, where
+// perf_event_open is available, branch_misses and cache_misses per record (see
+// perf_counters.hpp).  As in the suite, absl::StrCat writes doubles with 6 significant digits.
+//
+// Loading the corpus scans floating point fields, so the benchmark is only built where scan()
+// supports them (LAZYCAT_HAS_FLOATING_POINT_SCAN).
+
+#if defined(LAZYCAT_HAS_FLOATING_POINT_SCAN)
+namespace {
+
+#if !defined(LAZYCAT_BENCHMARK_CORPUS)
+#define LAZYCAT_BENCHMARK_CORPUS "corpus/log_records.tsv"
+#endif
+
+struct http_record {
+    std::string client_ip, method, path;
+    std::int32_t status;
+    std::int64_t bytes;
+    double duration_ms;
+};
+
+struct kv_record {
+    std::string level, component;
+    std::int64_t user_id;
+    std::int32_t retries;
+    std::string message;
+};
+
+struct metric_record {
+    std::string name, host;
+    double value;
+    std::int64_t timestamp_ms;
+};
+
+struct trade_record {
+    std::int64_t order_id;
+    std::string side;
+    std::int32_t quantity;
+    std::string symbol;
+    double price;
+};
+
+enum class record_kind : std::uint8_t { http, kv, metric, trade };
+
+struct Corpus {
+    std::vector<http_record> http;
+    std::vector<kv_record> kv;
+    std::vector<metric_record> metric;
+    std::vector<trade_record> trade;
+    std::vector<std::pair<record_kind, std::uint32_t>> records;  // in file order
+    std::string error;                                           // why loading failed
+
+    explicit Corpus(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = lazycat::cat("cannot open corpus ", path);
+            return;
+        }
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        const std::string content = std::move(buffer).str();
+        size_t line_number = 0;
+        for (std::string_view line : lazycat::split(content, '\n')) {
+            ++line_number;
+            if (line.empty()) continue;
+            if (!add(line)) {
+                error = lazycat::cat(path, ':', line_number, ": invalid record");
+                return;
+            }
+        }
+        if (records.empty()) error = lazycat::cat("empty corpus ", path);
+    }
+
+    bool add(std::string_view line) {
+        std::string_view kind, s[3];
+        if (!lazycat::scan(line, kind, '\t', s[0])) return false;
+        line = s[0];
+        if (kind == "http") {
+            http_record r;
+            if (!lazycat::scan(line, s[0], '\t', s[1], '\t', s[2], '\t', r.status, '\t', r.bytes,
+                               '\t', r.duration_ms)) {
+                return false;
+            }
+            r.client_ip = s[0], r.method = s[1], r.path = s[2];
+            return push(record_kind::http, http, std::move(r));
+        } else if (kind == "kv") {
+            kv_record r;
+            if (!lazycat::scan(line, s[0], '\t', s[1], '\t', r.user_id, '\t', r.retries, '\t',
+                               s[2])) {
+                return false;
+            }
+            r.level = s[0], r.component = s[1], r.message = s[2];
+            return push(record_kind::kv, kv, std::move(r));
+        } else if (kind == "metric") {
+            metric_record r;
+            if (!lazycat::scan(line, s[0], '\t', s[1], '\t', r.value, '\t', r.timestamp_ms)) {
+                return false;
+            }
+            r.name = s[0], r.host = s[1];
+            return push(record_kind::metric, metric, std::move(r));
+        } else if (kind == "trade") {
+            trade_record r;
+            if (!lazycat::scan(line, r.order_id, '\t', s[0], '\t', r.quantity, '\t', s[1], '\t',
+                               r.price)) {
+                return false;
+            }
+            r.side = s[0], r.symbol = s[1];
+            return push(record_kind::trade, trade, std::move(r));
+        }
+        return false;
+    }
+
+    template <typename Record>
+    bool push(record_kind kind, std::vector<Record>& v, Record&& r) {
+        records.emplace_back(kind, static_cast<std::uint32_t>(v.size()));
+        v.push_back(std::move(r));
+        return true;
+    }
+};
+
+const Corpus& corpus() {
+    static const Corpus instance([] {
+        const char* path = std::getenv("LAZYCAT_BENCHMARK_CORPUS");
+        return std::string(path && *path ? path : LAZYCAT_BENCHMARK_CORPUS);
+    }());
+    return instance;
+}
+
+// std::string rather than char or std::string_view, for absl::StrCat (as in benchmark_suite.cpp)
+const std::string space = " ";
+const std::string newline = "\n";
+const std::string dash = " - ";
+const std::string ms_newline = "ms\n";
+const std::string level_key = "level=";
+const std::string component_key = " component=";
+const std::string user_id_key = " user_id=";
+const std::string retries_key = " retries=";
+const std::string msg_key = " msg=\"";
+const std::string quote_newline = "\"\n";
+const std::string host_key = ",host=";
+const std::string value_key = " value=";
+const std::string order = "order ";
+const std::string at = " @ ";
+
+template <typename Lib>
+std::string build_record(const Corpus& c, record_kind kind, std::uint32_t index) {
+    switch (kind) {
+        case record_kind::http: {
+            const http_record& r = c.http[index];
+            return Lib::build(r.client_ip, dash, r.method, space, r.path, space, r.status, space,
+                              r.bytes, space, r.duration_ms, ms_newline);
+        }
+        case record_kind::kv: {
+            const kv_record& r = c.kv[index];
+            return Lib::build(level_key, r.level, component_key, r.component, user_id_key,
+                              r.user_id, retries_key, r.retries, msg_key, r.message,
+                              quote_newline);
+        }
+        case record_kind::metric: {
+            const metric_record& r = c.metric[index];
+            return Lib::build(r.name, host_key, r.host, value_key, r.value, space, r.timestamp_ms,
+                              newline);
+        }
+        case record_kind::trade: {
+            const trade_record& r = c.trade[index];
+            return Lib::build(order, r.order_id, space, r.side, space, r.quantity, space, r.symbol,
+                              at, r.price, newline);
+        }
+    }
+    return {};
+}
+
+template <typename Lib>
+void Corpus_Replay(benchmark::State& state) {
+    const Corpus& c = corpus();
+    if (!c.error.empty()) {
+        state.SkipWithError(c.error.c_str());
+        return;
+    }
+    size_t bytes = 0;
+    perf_counters perf;
+    reset_instrumentation();
+    perf.start();
+    for (auto _ : state) {
+        for (const auto& [kind, index] : c.records) {
+            std::string line = build_record<Lib>(c, kind, index);
+            bytes += line.size();
+            benchmark::DoNotOptimize(line);
+        }
+    }
+    perf.stop();
+    const auto records = static_cast<double>(c.records.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(c.records.size()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.counters["per_record"] = benchmark::Counter(
+        records, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    perf.report(state, records * static_cast<double>(state.iterations()));
+    report_instrumentation(state);
+}
+
+BENCHMARK_TEMPLATE(Corpus_Replay, LazyCat);
+BENCHMARK_TEMPLATE(Corpus_Replay, Abseil);
+BENCHMARK_TEMPLATE(Corpus_Replay, Fmt);
+#if defined(LAZYCAT_HAS_STD_FORMAT)
+BENCHMARK_TEMPLATE(Corpus_Replay, StdFormat);
+#endif
+BENCHMARK_TEMPLATE(Corpus_Replay, OStringStream);
+
+}  // namespace
+#endif
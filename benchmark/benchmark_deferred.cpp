@@ -0,0 +1,81 @@
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_deferred.hpp>
+#include <lazycat/lazycat_ring.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// Latency of the calling ("hot") thread when logging a number-heavy line: formatting it in place
+// into a ring_sink, versus capturing the raw arguments into a deferred_sink and formatting them
+// on a background worker.  The worker only counts the bytes.
+
+// Runs drain() of a sink on a background thread for the lifetime of the object.
+template <typename Sink>
+class Background_Worker {
+   public:
+    explicit Background_Worker(Sink& sink)
+        : thread_([this, &sink] {
+              size_t total = 0;
+              const auto count = [&](std::string_view message) { total += message.size(); };
+              while (!stop_.load(std::memory_order_relaxed)) {
+                  if (sink.drain(count) == 0) std::this_thread::yield();
+              }
+              sink.drain(count);
+              benchmark::DoNotOptimize(total);
+          }) {}
+    ~Background_Worker() {
+        stop_ = true;
+        thread_.join();
+    }
+
+   private:
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+struct Order {
+    std::int64_t id;
+    double price;
+    std::uint32_t quantity;
+    std::int32_t venue;
+    double latency_us;
+};
+
+Order next_order(Order o) {
+    return {o.id + 1, o.price + 0.01, o.quantity % 1000 + 1, o.venue ^ 7, o.latency_us * 1.0001};
+}
+
+void Deferred_Eager(benchmark::State& state) {
+    ring_sink sink(1 << 20);
+    Background_Worker worker(sink);
+    Order o{1000000, 101.25, 100, 3, 12.5};
+    for (auto _ : state) {
+        cat_into(sink, "order ", o.id, " price ", o.price, " qty ", o.quantity, " venue ", o.venue,
+                 " latency ", o.latency_us, "us\n");
+        o = next_order(o);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Deferred_Eager);
+
+void Deferred_Capture(benchmark::State& state) {
+    deferred_sink sink(1 << 20);
+    Background_Worker worker(sink);
+    Order o{1000000, 101.25, 100, 3, 12.5};
+    for (auto _ : state) {
+        sink.capture("order ", o.id, " price ", o.price, " qty ", o.quantity, " venue ", o.venue,
+                     " latency ", o.latency_us, "us\n");
+        o = next_order(o);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Deferred_Capture);
+
+}  // namespace
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_deflate.hpp>
+
+#if defined(LAZYCAT_HAS_ZLIB)
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+using namespace lazycat;
+
+namespace {
+
+// Compresses 10000 log lines at zlib level state.range(0): streamed with deflate_sink versus
+// concatenated into one string with append() and then compressed.  Compressed chunks go to the
+// same sink, which only counts them.
+
+constexpr int lines = 10000;
+
+struct counting_output {
+    size_t* bytes;
+    void operator()(std::string_view chunk) const {
+        benchmark::DoNotOptimize(chunk.data());
+        *bytes += chunk.size();
+    }
+};
+
+void set_counters(benchmark::State& state, size_t compressed_bytes) {
+    state.SetItemsProcessed(state.iterations() * lines);
+    state.counters["compressed_bytes_per_second"] = benchmark::Counter(
+        static_cast<double>(compressed_bytes), benchmark::Counter::kIsRate);
+}
+
+void Deflate_Stream(benchmark::State& state) {
+    size_t compressed_bytes = 0;
+    for (auto _ : state) {
+        deflate_sink out(counting_output{&compressed_bytes}, static_cast<int>(state.range(0)));
+        for (std::int64_t i = 0; i != lines; ++i) {
+            cat_into(out, 1700000000000 + i * 17, " GET /api/items/", i % 1000, " 200 ",
+                     (i % 97) * 0.125, "ms\n");
+        }
+        out.finish();
+    }
+    set_counters(state, compressed_bytes);
+}
+BENCHMARK(Deflate_Stream)->Arg(1)->Arg(6);
+
+void Deflate_BuildThenCompress(benchmark::State& state) {
+    size_t compressed_bytes = 0;
+    const counting_output output{&compressed_bytes};
+    const auto compressed = std::make_unique<char[]>(size_t{64} << 10);
+    for (auto _ : state) {
+        std::string text;
+        for (std::int64_t i = 0; i != lines; ++i) {
+            append(text, 1700000000000 + i * 17, " GET /api/items/", i % 1000, " 200 ",
+                   (i % 97) * 0.125, "ms\n")
+                .build();
+        }
+        z_stream stream{};
+        deflateInit2(&stream, static_cast<int>(state.range(0)), Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY);
+        stream.next_in = reinterpret_cast<Bytef*>(text.data());
+        stream.avail_in = static_cast<uInt>(text.size());
+        int ret;
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(compressed.get());
+            stream.avail_out = 64 << 10;
+            ret = deflate(&stream, Z_FINISH);
+            output(std::string_view(compressed.get(), (64 << 10) - stream.avail_out));
+        } while (ret != Z_STREAM_END);
+        deflateEnd(&stream);
+    }
+    set_counters(state, compressed_bytes);
+}
+BENCHMARK(Deflate_BuildThenCompress)->Arg(1)->Arg(6);
+
+}  // namespace
+
+#endif
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// The size pass over an array of 4096 integers of random bit widths (and signs): digit_counts()
+// and total_size(), which are vectorized with AVX2, versus calculate_integral_size() per value.
+// Build with -mavx2 (or -march=native) to compare the vector paths.
+
+constexpr size_t count = 4096;
+
+template <typename T>
+std::vector<T> random_values() {
+    std::mt19937_64 rng(42);
+    std::vector<T> ret(count);
+    for (T& v : ret) v = static_cast<T>(rng() >> (rng() % 64));
+    return ret;
+}
+
+template <typename T>
+constexpr size_t max_digits = std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1;
+
+template <typename T>
+void DigitCounts_Scalar(benchmark::State& state) {
+    const std::vector<T> values = random_values<T>();
+    std::vector<std::uint8_t> counts(count);
+    for (auto _ : state) {
+        for (size_t i = 0; i != count; ++i) {
+            counts[i] = static_cast<std::uint8_t>(
+                detail::calculate_integral_size<max_digits<T>>(values[i]));
+        }
+        benchmark::DoNotOptimize(counts.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(DigitCounts_Scalar<std::int32_t>);
+BENCHMARK(DigitCounts_Scalar<std::int64_t>);
+
+template <typename T>
+void DigitCounts_Vector(benchmark::State& state) {
+    const std::vector<T> values = random_values<T>();
+    std::vector<std::uint8_t> counts(count);
+    for (auto _ : state) {
+        detail::digit_counts(std::span<const T>(values), counts.data());
+        benchmark::DoNotOptimize(counts.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(DigitCounts_Vector<std::int32_t>);
+BENCHMARK(DigitCounts_Vector<std::int64_t>);
+
+template <typename T>
+void TotalSize_Scalar(benchmark::State& state) {
+    const std::vector<T> values = random_values<T>();
+    for (auto _ : state) {
+        size_t total = 0;
+        for (size_t i = 0; i != count; ++i) {
+            total += detail::calculate_integral_size<max_digits<T>>(values[i]);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(TotalSize_Scalar<std::int32_t>);
+BENCHMARK(TotalSize_Scalar<std::int64_t>);
+
+template <typename T>
+void TotalSize_Vector(benchmark::State& state) {
+    const std::vector<T> values = random_values<T>();
+    for (auto _ : state) benchmark::DoNotOptimize(detail::total_size(std::span<const T>(values)));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(TotalSize_Vector<std::int32_t>);
+BENCHMARK(TotalSize_Vector<std::int64_t>);
+
+}  // namespace
@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// A query log line whose fields depend on runtime configuration.
+class Dynamic_Fixture : public benchmark::Fixture {
+   public:
+    inline static std::string query, user, database;
+    inline static std::int64_t rows;
+    inline static double elapsed_ms;
+    inline static bool log_user, log_database, log_rows, log_time;
+    void SetUp(const ::benchmark::State&) {
+        query = "SELECT id, name, created_at FROM accounts WHERE region = 'ap-southeast-1'";
+        user = "reporting_service";
+        database = "accounts_replica_3";
+        rows = 18234;
+        elapsed_ms = 12.75;
+        log_user = true;
+        log_database = false;
+        log_rows = true;
+        log_time = true;
+    }
+
+    void TearDown(const ::benchmark::State&) {
+        query.clear();
+        user.clear();
+        database.clear();
+    }
+};
+
+BENCHMARK_F(Dynamic_Fixture, Dynamic_Query_LazyCat)(benchmark::State& state) {
+    for (auto _ : state) {
+        dynamic_cat msg;
+        msg << "query=" << query;
+        if (log_user) msg << " user=" << user;
+        if (log_database) msg << " db=" << database;
+        if (log_rows) msg << " rows=" << rows;
+        if (log_time) msg << " time=" << elapsed_ms << "ms";
+        std::string total = msg;
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Dynamic_Fixture, Dynamic_Query_Append)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string total = "query=";
+        total += query;
+        if (log_user) {
+            total += " user=";
+            total += user;
+        }
+        if (log_database) {
+            total += " db=";
+            total += database;
+        }
+        if (log_rows) {
+            total += " rows=";
+            total += std::to_string(rows);
+        }
+        if (log_time) {
+            total += " time=";
+            total += std::to_string(elapsed_ms);
+            total += "ms";
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Dynamic_Fixture, Dynamic_Query_Ostringstream)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::ostringstream os;
+        os << "query=" << query;
+        if (log_user) os << " user=" << user;
+        if (log_database) os << " db=" << database;
+        if (log_rows) os << " rows=" << rows;
+        if (log_time) os << " time=" << elapsed_ms << "ms";
+        std::string total = os.str();
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+}  // namespace
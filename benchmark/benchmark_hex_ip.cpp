@@ -0,0 +1,64 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+class Access_Log_Fixture : public benchmark::Fixture {
+   public:
+    inline static std::uint32_t client;
+    inline static std::array<std::uint8_t, 16> request_id, client6;
+    inline static std::array<std::uint8_t, 32> digest;
+    void SetUp(const ::benchmark::State&) {
+        client = 0xC0A8640B;
+        for (std::uint8_t i = 0; i != 16; ++i) request_id[i] = static_cast<std::uint8_t>(i * 29);
+        client6 = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x02, 0xb3, 0xff};
+        for (std::uint8_t i = 0; i != 32; ++i) digest[i] = static_cast<std::uint8_t>(i * 83);
+    }
+
+    void TearDown(const ::benchmark::State&) {}
+};
+
+std::string naive_hex(const std::uint8_t* bytes, size_t count) {
+    static const char digits[] = "0123456789abcdef";
+    std::string ret;
+    for (size_t i = 0; i != count; ++i) {
+        ret += digits[bytes[i] >> 4];
+        ret += digits[bytes[i] & 0x0F];
+    }
+    return ret;
+}
+
+BENCHMARK_F(Access_Log_Fixture, Access_Log_Snprintf)(benchmark::State& state) {
+    for (auto _ : state) {
+        char ip[16];
+        const int len = std::snprintf(ip, sizeof(ip), "%u.%u.%u.%u", client >> 24,
+                                      (client >> 16) & 0xFF, (client >> 8) & 0xFF, client & 0xFF);
+        std::string total = cat(std::string_view(ip, len), " id=", naive_hex(request_id.data(), 16),
+                                " sha256=", naive_hex(digest.data(), 32));
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Access_Log_Fixture, Access_Log_LazyCat)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string total =
+            cat(ipv4(client), " id=", uuid(request_id), " sha256=", hex_bytes(digest));
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Access_Log_Fixture, Access_Log_IPv6_LazyCat)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string total = cat(ipv6(client6));
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#include <absl/strings/str_cat.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <lazycat/lazycat.hpp>
+
+// The string building libraries compared by the Suite_* and Corpus_* benchmarks.  Each has a
+// static build(args...), which returns a new string, and append(out, args...), which appends to an
+// existing one.  LAZYCAT_HAS_STD_FORMAT is defined if std::format is available.
+
+// "{}" repeated N times, for the format-based libraries
+template <size_t N>
+struct braces {
+    static constexpr auto storage = []() {
+        std::array<char, N * 2> ret{};
+        for (size_t i = 0; i != N; ++i) {
+            ret[i * 2] = '{';
+            ret[i * 2 + 1] = '}';
+        }
+        return ret;
+    }();
+    static constexpr std::string_view value{storage.data(), storage.size()};
+};
+
+struct LazyCat {
+    template <typename... Ts>
+    static std::string build(const Ts&... ts) {
+        return lazycat::cat(ts...);
+    }
+    template <typename... Ts>
+    static void append(std::string& out, const Ts&... ts) {
+        lazycat::append(out, ts...).build();
+    }
+};
+
+struct Abseil {
+    template <typename... Ts>
+    static std::string build(const Ts&... ts) {
+        return absl::StrCat(ts...);
+    }
+    template <typename... Ts>
+    static void append(std::string& out, const Ts&... ts) {
+        absl::StrAppend(&out, ts...);
+    }
+};
+
+struct Fmt {
+    template <typename... Ts>
+    static std::string build(const Ts&... ts) {
+        return fmt::format(braces<sizeof...(Ts)>::value, ts...);
+    }
+    template <typename... Ts>
+    static void append(std::string& out, const Ts&... ts) {
+        fmt::format_to(std::back_inserter(out), braces<sizeof...(Ts)>::value, ts...);
+    }
+};
+
+#if defined(__cpp_lib_format) && __cpp_lib_format >= 201907L
+#define LAZYCAT_HAS_STD_FORMAT
+struct StdFormat {
+    template <typename... Ts>
+    static std::string build(const Ts&... ts) {
+        return std::format(braces<sizeof...(Ts)>::value, ts...);
+    }
+    template <typename... Ts>
+    static void append(std::string& out, const Ts&... ts) {
+        std::format_to(std::back_inserter(out), braces<sizeof...(Ts)>::value, ts...);
+    }
+};
+#endif
+
+struct OStringStream {
+    template <typename... Ts>
+    static std::string build(const Ts&... ts) {
+        std::ostringstream os;
+        (os << ... << ts);
+        return std::move(os).str();
+    }
+    template <typename... Ts>
+    static void append(std::string& out, const Ts&... ts) {
+        std::ostringstream os(std::move(out), std::ios_base::ate);
+        (os << ... << ts);
+        out = std::move(os).str();
+    }
+};
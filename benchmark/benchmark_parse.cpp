@@ -0,0 +1,62 @@
+#include <charconv>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// Parses a line of 1024 comma-separated unsigned 64-bit numbers of exactly state.range(0) digits:
+// parse_integral versus std::from_chars.
+
+constexpr int count = 1024;
+
+std::string numbers_with_digits(int digits) {
+    std::mt19937_64 rng(digits);
+    std::string ret;
+    for (int i = 0; i != count; ++i) {
+        std::string s(static_cast<size_t>(digits), '0');
+        for (char& c : s) c = static_cast<char>('0' + rng() % 10);
+        if (digits > 1 && s[0] == '0') s[0] = '1';
+        if (digits == 20 && s[0] > '1') s[0] = '1';  // stay below 2^64
+        ret += s;
+        ret += ',';
+    }
+    return ret;
+}
+
+void Parse_LazyCat(benchmark::State& state) {
+    const std::string line = numbers_with_digits(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        const char* p = line.data();
+        const char* const last = line.data() + line.size();
+        for (int i = 0; i != count; ++i) {
+            std::uint64_t value = 0;
+            p = parse_integral(p, last, value).ptr + 1;
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(Parse_LazyCat)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(12)->Arg(16)->Arg(19)->Arg(20);
+
+void Parse_FromChars(benchmark::State& state) {
+    const std::string line = numbers_with_digits(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        const char* p = line.data();
+        const char* const last = line.data() + line.size();
+        for (int i = 0; i != count; ++i) {
+            std::uint64_t value = 0;
+            p = std::from_chars(p, last, value).ptr + 1;
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(Parse_FromChars)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(12)->Arg(16)->Arg(19)->Arg(20);
+
+}  // namespace
@@ -0,0 +1,58 @@
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// One row of a rendered table: an indented, padded cell followed by a separator line.
+class Table_Row_Fixture : public benchmark::Fixture {
+   public:
+    inline static std::string cell;
+    inline static size_t indent, padding, width;
+    void SetUp(const ::benchmark::State&) {
+        cell = "throughput";
+        indent = 8;
+        padding = 22;
+        width = 60;
+    }
+
+    void TearDown(const ::benchmark::State&) { cell.clear(); }
+};
+
+BENCHMARK_F(Table_Row_Fixture, Table_Row_Temporaries)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string total = cat(std::string(indent, ' '), cell, std::string(padding, ' '), '|',
+                                '\n', std::string(indent, ' '), std::string(width, '-'));
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Table_Row_Fixture, Table_Row_LazyCat)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string total = cat(fill(' ', indent), cell, fill(' ', padding), '|', '\n',
+                                fill(' ', indent), fill('-', width));
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Table_Row_Fixture, Table_Row_Pattern_Temporaries)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string separator;
+        for (size_t i = 0; i != width / 2; ++i) separator += "-+";
+        std::string total = cat(cell, '\n', separator);
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK_F(Table_Row_Fixture, Table_Row_Pattern_LazyCat)(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string total = cat(cell, '\n', repeat("-+", width / 2));
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+}  // namespace
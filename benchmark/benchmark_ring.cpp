@@ -0,0 +1,106 @@
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_ring.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// Several threads assemble access log lines into a shared sink while one consumer thread drains
+// it.  The consumer only counts the bytes, so that the numbers measure the producers and the
+// handoff rather than the file system.
+
+const std::string method = "GET";
+const std::string path = "/api/v1/items";
+
+// Shared state, set up by thread 0 before the timed loop (google benchmark starts and stops all
+// threads of a run together).
+struct Ring_State {
+    ring_sink ring{1 << 20};
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> bytes{0};
+    std::thread consumer;
+
+    void start() {
+        stop = false;
+        consumer = std::thread([this] {
+            size_t total = 0;
+            const auto count = [&](std::string_view message) { total += message.size(); };
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (ring.drain(count) == 0) std::this_thread::yield();
+            }
+            ring.drain(count);
+            bytes += total;
+        });
+    }
+    void finish() {
+        stop = true;
+        consumer.join();
+    }
+};
+Ring_State ring_state;
+
+void Ring_LazyCat(benchmark::State& state) {
+    if (state.thread_index() == 0) ring_state.start();
+    int id = state.thread_index() * 1000000;
+    for (auto _ : state) {
+        cat_into(ring_state.ring, method, ' ', path, '/', ++id, " 200 ", 0.25, "ms\n");
+    }
+    if (state.thread_index() == 0) ring_state.finish();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Ring_LazyCat)->ThreadRange(1, 8)->UseRealTime();
+
+// Baseline: producers append to a shared string under a mutex, and the consumer swaps it out.
+struct Mutex_State {
+    std::mutex mutex;
+    std::string buffer;
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> bytes{0};
+    std::thread consumer;
+
+    void start() {
+        stop = false;
+        consumer = std::thread([this] {
+            std::string local;
+            size_t total = 0;
+            for (bool last = false; !last;) {
+                last = stop.load(std::memory_order_relaxed);
+                {
+                    std::lock_guard lock(mutex);
+                    local.swap(buffer);
+                }
+                total += local.size();
+                if (local.empty()) std::this_thread::yield();
+                local.clear();
+            }
+            bytes += total;
+        });
+    }
+    void finish() {
+        stop = true;
+        consumer.join();
+    }
+};
+Mutex_State mutex_state;
+
+void Ring_MutexAppend(benchmark::State& state) {
+    if (state.thread_index() == 0) mutex_state.start();
+    int id = state.thread_index() * 1000000;
+    for (auto _ : state) {
+        ++id;
+        std::lock_guard lock(mutex_state.mutex);
+        append(mutex_state.buffer, method, ' ', path, '/', id, " 200 ", 0.25, "ms\n").build();
+    }
+    if (state.thread_index() == 0) mutex_state.finish();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Ring_MutexAppend)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace
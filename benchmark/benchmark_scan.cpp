@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_scan.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// Parses CSV lines written by cat() back into fields: scan() versus std::getline and std::stoi,
+// and split() versus repeated std::string_view::find on long lines.
+
+const std::vector<std::string>& csv_lines() {
+    static const std::vector<std::string> lines = [] {
+        std::vector<std::string> ret;
+        for (std::int64_t i = 0; i != 1024; ++i) {
+            ret.push_back(cat(i * 7919, ',', "item-", i, ',', i * 0.125, ',', i % 100));
+        }
+        return ret;
+    }();
+    return lines;
+}
+
+void Scan_LazyCat(benchmark::State& state) {
+    const auto& lines = csv_lines();
+    for (auto _ : state) {
+        for (const std::string& line : lines) {
+            std::int64_t id;
+            std::string_view name;
+#if defined(LAZYCAT_HAS_FLOATING_POINT_SCAN)
+            double price;
+#else
+            std::string_view price;
+#endif
+            int qty;
+            scan(line, id, ',', name, ',', price, ',', qty);
+            benchmark::DoNotOptimize(id);
+            benchmark::DoNotOptimize(name);
+            benchmark::DoNotOptimize(price);
+            benchmark::DoNotOptimize(qty);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(Scan_LazyCat);
+
+void Scan_Getline(benchmark::State& state) {
+    const auto& lines = csv_lines();
+    for (auto _ : state) {
+        for (const std::string& line : lines) {
+            std::istringstream in(line);
+            std::string id, name, price, qty;
+            std::getline(in, id, ',');
+            std::getline(in, name, ',');
+            std::getline(in, price, ',');
+            std::getline(in, qty, ',');
+            const long long id_value = std::stoll(id);
+            const double price_value = std::stod(price);
+            const int qty_value = std::stoi(qty);
+            benchmark::DoNotOptimize(id_value);
+            benchmark::DoNotOptimize(name);
+            benchmark::DoNotOptimize(price_value);
+            benchmark::DoNotOptimize(qty_value);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(Scan_Getline);
+
+// One line of 64 fields of the given length.
+std::string long_line(size_t field_length) {
+    std::string ret;
+    for (int i = 0; i != 64; ++i) {
+        if (i != 0) ret += '\t';
+        ret.append(field_length, 'x');
+    }
+    return ret;
+}
+
+void Split_LazyCat(benchmark::State& state) {
+    const std::string line = long_line(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        for (std::string_view field : split(line, '\t')) benchmark::DoNotOptimize(field);
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(Split_LazyCat)->Arg(4)->Arg(32)->Arg(256);
+
+void Split_Find(benchmark::State& state) {
+    const std::string line = long_line(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::string_view rest = line;
+        for (;;) {
+            const size_t pos = rest.find('\t');
+            std::string_view field = rest.substr(0, pos);
+            benchmark::DoNotOptimize(field);
+            if (pos == std::string_view::npos) break;
+            rest.remove_prefix(pos + 1);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(Split_Find)->Arg(4)->Arg(32)->Arg(256);
+
+}  // namespace
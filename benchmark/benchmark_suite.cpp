@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+#include "benchmark_libraries.hpp"
+#include "instrumentation_counters.hpp"
+
+// Parameterized benchmark suite comparing lazycat with other string building libraries.
+//
+// Every benchmark is templated on a library and parameterized on the workload:
+//   Suite_Mixed<Lib>/args:N      N arguments (1 to 64) cycling through string, int32 and double
+//   Suite_Strings<Lib>/len:L     5 strings whose lengths are uniform in [L/2, 3L/2]
+//   Suite_Integers<Lib>/dist:D   8 int32 values with digit lengths from distribution D
+//   Suite_Append<Lib>/lines:K    K log lines appended one at a time to an initially empty string
+// The values come from a fixed-seed pool that is larger than the branch predictor can memorize,
+// and each iteration uses the next row of the pool.
+//
+// In lazycat_benchmark_instrumented, the lazycat benchmarks also report allocations, reallocations
+// and the time spent in size() and write() per iteration (see instrumentation_counters.hpp).
+//
+// Run with --benchmark_filter=Suite_ --benchmark_out=run.json --benchmark_out_format=json, and
+// compare two runs with compare_benchmarks.py.  Note that the libraries do not format doubles
+// identically (absl::StrCat uses 6 significant digits, the others use the shortest round-trip
+// form), so the Mixed and Append workloads are not byte-for-byte identical across libraries.
+
+namespace {
+
+constexpr size_t pool_size = 4096;  // must be a power of 2
+constexpr size_t pool_mask = pool_size - 1;
+constexpr std::uint64_t pool_seed = 0x1a2ca7;
+
+// std::string rather than std::string_view, because absl::string_view may be a distinct type
+const std::string space = " ";
+const std::string newline = "\n";
+
+std::string random_string(std::mt19937_64& rng, size_t length) {
+    constexpr std::string_view alphabet =
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-/.";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::string ret(length, ' ');
+    for (char& c : ret) c = alphabet[pick(rng)];
+    return ret;
+}
+
+// Digit length distributions for integers
+enum digit_distribution : int {
+    // Uniform over the whole int32 range, so almost all values have 9 or 10 digits.
+    uniform_range = 0,
+    // Uniform digit length from 1 to 10, i.e. log-uniform values.
+    uniform_digits = 1,
+    // Mostly small values, as in counters, status codes and small ids: 70% below 100, 25% below
+    // 100000, and 5% over the whole range.  One in ten is negative.
+    mostly_small = 2,
+};
+
+std::int32_t random_int(std::mt19937_64& rng, digit_distribution dist) {
+    std::uniform_int_distribution<std::int32_t> full(std::numeric_limits<std::int32_t>::min(),
+                                                     std::numeric_limits<std::int32_t>::max());
+    switch (dist) {
+        case uniform_range:
+            return full(rng);
+        case uniform_digits: {
+            const int digits = std::uniform_int_distribution<int>(1, 10)(rng);
+            std::int64_t low = 1;
+            for (int i = 1; i < digits; ++i) low *= 10;
+            const std::int64_t high =
+                std::min<std::int64_t>(low * 10 - 1, std::numeric_limits<std::int32_t>::max());
+            if (digits == 1) low = 0;
+            const auto val = std::uniform_int_distribution<std::int64_t>(low, high)(rng);
+            return static_cast<std::int32_t>(rng() % 2 == 0 ? val : -val);
+        }
+        case mostly_small: {
+            const unsigned bucket = rng() % 100;
+            std::int32_t val;
+            if (bucket < 70) {
+                val = std::uniform_int_distribution<std::int32_t>(0, 99)(rng);
+            } else if (bucket < 95) {
+                val = std::uniform_int_distribution<std::int32_t>(100, 99999)(rng);
+            } else {
+                return full(rng);
+            }
+            return rng() % 10 == 0 ? -val : val;
+        }
+    }
+    return 0;
+}
+
+double random_double(std::mt19937_64& rng) {
+    // Latencies in milliseconds, with a long tail
+    return std::lognormal_distribution<double>(1.0, 1.5)(rng);
+}
+
+// Precomputed values for all the workloads
+struct Corpus {
+    std::vector<std::string> words;         // lengths uniform in [4, 16]
+    std::vector<std::int32_t> ints;         // uniform_digits
+    std::vector<double> doubles;            // random_double
+    std::vector<std::string> strings;       // for Suite_Strings, regenerated for each length
+    std::vector<std::int32_t> integers[3];  // one pool per digit_distribution
+
+    Corpus() {
+        std::mt19937_64 rng(pool_seed);
+        for (size_t i = 0; i != pool_size; ++i) {
+            words.push_back(random_string(rng, std::uniform_int_distribution<size_t>(4, 16)(rng)));
+            ints.push_back(random_int(rng, uniform_digits));
+            doubles.push_back(random_double(rng));
+        }
+        for (int d = 0; d != 3; ++d) {
+            for (size_t i = 0; i != pool_size; ++i) {
+                integers[d].push_back(random_int(rng, static_cast<digit_distribution>(d)));
+            }
+        }
+    }
+
+    void make_strings(size_t length) {
+        std::mt19937_64 rng(pool_seed ^ length);
+        std::uniform_int_distribution<size_t> pick_length(length / 2, length * 3 / 2);
+        strings.clear();
+        for (size_t i = 0; i != pool_size; ++i) {
+            strings.push_back(random_string(rng, pick_length(rng)));
+        }
+    }
+};
+
+Corpus& corpus() {
+    static Corpus instance;
+    return instance;
+}
+
+// The Ith argument of a mixed expression in the given row of the pool.
+template <size_t I>
+const auto& mixed_arg(const Corpus& c, size_t row) {
+    if constexpr (I % 3 == 0) {
+        return c.words[(row + I) & pool_mask];
+    } else if constexpr (I % 3 == 1) {
+        return c.ints[(row + I) & pool_mask];
+    } else {
+        return c.doubles[(row + I) & pool_mask];
+    }
+}
+
+template <typename Lib, size_t... Is>
+void run_mixed(benchmark::State& state, std::index_sequence<Is...>) {
+    const Corpus& c = corpus();
+    size_t row = 0;
+    reset_instrumentation();
+    for (auto _ : state) {
+        std::string total = Lib::build(mixed_arg<Is>(c, row)...);
+        benchmark::DoNotOptimize(total);
+        row = (row + sizeof...(Is)) & pool_mask;
+    }
+    state.SetItemsProcessed(state.iterations() * sizeof...(Is));
+    report_instrumentation(state);
+}
+
+template <typename Lib>
+void Suite_Mixed(benchmark::State& state) {
+    // The number of arguments has to be known at compile time
+    switch (state.range(0)) {
+        case 1: return run_mixed<Lib>(state, std::make_index_sequence<1>());
+        case 2: return run_mixed<Lib>(state, std::make_index_sequence<2>());
+        case 4: return run_mixed<Lib>(state, std::make_index_sequence<4>());
+        case 8: return run_mixed<Lib>(state, std::make_index_sequence<8>());
+        case 16: return run_mixed<Lib>(state, std::make_index_sequence<16>());
+        case 32: return run_mixed<Lib>(state, std::make_index_sequence<32>());
+        case 64: return run_mixed<Lib>(state, std::make_index_sequence<64>());
+        default: state.SkipWithError("unsupported number of arguments");
+    }
+}
+
+template <typename Lib>
+void Suite_Strings(benchmark::State& state) {
+    Corpus& c = corpus();
+    c.make_strings(static_cast<size_t>(state.range(0)));
+    size_t row = 0, bytes = 0;
+    reset_instrumentation();
+    for (auto _ : state) {
+        const auto& s = c.strings;
+        std::string total = Lib::build(s[row], s[(row + 1) & pool_mask], s[(row + 2) & pool_mask],
+                                       s[(row + 3) & pool_mask], s[(row + 4) & pool_mask]);
+        bytes += total.size();
+        benchmark::DoNotOptimize(total);
+        row = (row + 5) & pool_mask;
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    report_instrumentation(state);
+}
+
+template <typename Lib>
+void Suite_Integers(benchmark::State& state) {
+    const auto& ints = corpus().integers[state.range(0)];
+    size_t row = 0;
+    reset_instrumentation();
+    for (auto _ : state) {
+        const std::int32_t* v = &ints[row];
+        std::string total = Lib::build(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+        benchmark::DoNotOptimize(total);
+        row = (row + 8) & pool_mask;
+    }
+    state.SetItemsProcessed(state.iterations() * 8);
+    report_instrumentation(state);
+}
+
+template <typename Lib>
+void Suite_Append(benchmark::State& state) {
+    const Corpus& c = corpus();
+    const size_t lines = static_cast<size_t>(state.range(0));
+    size_t row = 0, bytes = 0;
+    reset_instrumentation();
+    for (auto _ : state) {
+        std::string out;  // grows with the usual geometric reallocation
+        for (size_t i = 0; i != lines; ++i) {
+            Lib::append(out, c.words[row], space, c.ints[row], space, c.doubles[row], newline);
+            row = (row + 1) & pool_mask;
+        }
+        bytes += out.size();
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines));
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    report_instrumentation(state);
+}
+
+#define LAZYCAT_SUITE_MIXED(Lib) \
+    BENCHMARK_TEMPLATE(Suite_Mixed, Lib)->RangeMultiplier(2)->Range(1, 64)->ArgName("args")
+#define LAZYCAT_SUITE_STRINGS(Lib) \
+    BENCHMARK_TEMPLATE(Suite_Strings, Lib)->Arg(8)->Arg(64)->Arg(4096)->ArgName("len")
+#define LAZYCAT_SUITE_INTEGERS(Lib) \
+    BENCHMARK_TEMPLATE(Suite_Integers, Lib)->DenseRange(0, 2)->ArgName("dist")
+#define LAZYCAT_SUITE_APPEND(Lib) \
+    BENCHMARK_TEMPLATE(Suite_Append, Lib)->Arg(16)->Arg(256)->Arg(4096)->ArgName("lines")
+#define LAZYCAT_SUITE(Lib)       \
+    LAZYCAT_SUITE_MIXED(Lib);    \
+    LAZYCAT_SUITE_STRINGS(Lib);  \
+    LAZYCAT_SUITE_INTEGERS(Lib); \
+    LAZYCAT_SUITE_APPEND(Lib)
+
+LAZYCAT_SUITE(LazyCat);
+LAZYCAT_SUITE(Abseil);
+LAZYCAT_SUITE(Fmt);
+#if defined(LAZYCAT_HAS_STD_FORMAT)
+LAZYCAT_SUITE(StdFormat);
+#endif
+LAZYCAT_SUITE(OStringStream);
+
+}  // namespace
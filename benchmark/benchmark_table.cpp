@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_table.hpp>
+
+using namespace lazycat;
+
+namespace {
+
+// Formats a table of 100000 rows (an id, a quantity, a price and a name) as CSV: format_table()
+// versus appending one row at a time to a reserved string, and versus one cat() per row.
+
+constexpr size_t rows = 100000;
+
+struct table {
+    std::vector<std::int64_t> ids;
+    std::vector<std::int32_t> quantities;
+    std::vector<double> prices;
+    std::vector<std::string_view> names;
+};
+
+const table& make_table() {
+    static const table t = [] {
+        static const std::string_view words[] = {"apple", "banana", "cherry", "dragon fruit"};
+        std::mt19937_64 rng(42);
+        table ret;
+        for (size_t i = 0; i != rows; ++i) {
+            ret.ids.push_back(static_cast<std::int64_t>(rng() >> (rng() % 64)));
+            ret.quantities.push_back(static_cast<std::int32_t>(rng() % 1000));
+            ret.prices.push_back(static_cast<double>(rng() % 100000) / 100);
+            ret.names.push_back(words[rng() % 4]);
+        }
+        return ret;
+    }();
+    return t;
+}
+
+void FormatTable_Columns(benchmark::State& state) {
+    const table& t = make_table();
+    const unsigned threads = static_cast<unsigned>(state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string csv =
+            format_table({.threads = threads}, t.ids, t.quantities, t.prices, t.names);
+        bytes += csv.size();
+        benchmark::DoNotOptimize(csv);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+}
+BENCHMARK(FormatTable_Columns)->Arg(1)->Arg(4)->UseRealTime();
+
+void FormatTable_AppendPerRow(benchmark::State& state) {
+    const table& t = make_table();
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string csv;
+        csv.reserve(rows * 32);
+        for (size_t i = 0; i != rows; ++i) {
+            append(csv, t.ids[i], ',', t.quantities[i], ',', t.prices[i], ',', t.names[i], '\n')
+                .build();
+        }
+        bytes += csv.size();
+        benchmark::DoNotOptimize(csv);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+}
+BENCHMARK(FormatTable_AppendPerRow);
+
+void FormatTable_CatPerRow(benchmark::State& state) {
+    const table& t = make_table();
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string csv;
+        for (size_t i = 0; i != rows; ++i) {
+            csv += cat(t.ids[i], ',', t.quantities[i], ',', t.prices[i], ',', t.names[i], '\n');
+        }
+        bytes += csv.size();
+        benchmark::DoNotOptimize(csv);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(rows));
+}
+BENCHMARK(FormatTable_CatPerRow);
+
+}  // namespace
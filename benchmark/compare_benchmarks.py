@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON outputs and reports regressions.
+
+Usage:
+    lazycat_benchmark --benchmark_filter=Suite_ --benchmark_repetitions=5 \\
+        --benchmark_out=base.json --benchmark_out_format=json
+    (rebuild with the change)
+    lazycat_benchmark ... --benchmark_out=new.json --benchmark_out_format=json
+    compare_benchmarks.py base.json new.json [--threshold 5] [--metric cpu_time]
+
+When the runs have repetitions, the median aggregate is compared; otherwise the mean of the
+iterations with the same name.  Exits with status 1 if any benchmark is slower than the baseline
+by more than the threshold (in percent), so it can gate CI.
+"""
+
+import argparse
+import json
+import sys
+from statistics import mean
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    """Returns {benchmark name: time in ns} for one JSON file."""
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    iterations, medians = {}, {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        name = bench.get("run_name", bench["name"])
+        value = bench[metric] * TIME_UNIT_NS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = value
+        else:
+            iterations.setdefault(name, []).append(value)
+    result = {name: mean(values) for name, values in iterations.items()}
+    result.update(medians)
+    return result
+
+
+def format_ns(value):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if value >= scale:
+            return f"{value / scale:.2f} {unit}"
+    return f"{value:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="JSON output of the baseline run")
+    parser.add_argument("contender", help="JSON output of the run to check")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="slowdown in percent that counts as a regression (default: 5)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    parser.add_argument("--filter", default="", help="only compare names containing this string")
+    args = parser.parse_args()
+
+    base = load(args.baseline, args.metric)
+    new = load(args.contender, args.metric)
+    names = [name for name in base if name in new and args.filter in name]
+    if not names:
+        print("No benchmarks in common", file=sys.stderr)
+        return 2
+
+    width = max(len(name) for name in names)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>10}  {'Contender':>10}  {'Change':>8}")
+    regressions = []
+    for name in names:
+        change = (new[name] - base[name]) / base[name] * 100
+        if change > args.threshold:
+            marker = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            marker = "  improved"
+        else:
+            marker = ""
+        print(f"{name:<{width}}  {format_ns(base[name]):>10}  {format_ns(new[name]):>10}  "
+              f"{change:>+7.1f}%{marker}")
+
+    for name in sorted(set(base) - set(new)):
+        if args.filter in name:
+            print(f"missing from contender: {name}")
+    for name in sorted(set(new) - set(base)):
+        if args.filter in name:
+            print(f"new in contender: {name}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {args.threshold}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Measures the compile-time cost of cat() expressions.
+
+Generates translation units with N call sites of K arguments each (argument types are drawn from a
+fixed-seed mix of strings, string views, literals, integers, doubles, chars and bools, so that
+call sites do not share instantiations more than real code does), compiles each one, and reports
+the compile time and object size, minus those of a translation unit that only includes lazycat.
+
+With --depth-budget D, it also checks that a single cat() of the largest K compiles with
+-ftemplate-depth=D (GCC and Clang), and exits with status 1 if it does not.  This guards against
+changes that make the instantiation depth grow with the number of arguments.
+
+Usage:
+    compile_time_benchmark.py --compiler g++ --include src [--calls 100,500] [--args 2,8,16,40]
+                              [--flags "-O2 -std=c++20"] [--json out.json] [--depth-budget 64]
+"""
+
+import argparse
+import json
+import os
+import random
+import shlex
+import subprocess
+import sys
+import tempfile
+import time
+
+# (type of the variable, or None for a string literal)
+ARGUMENT_KINDS = [
+    "std::string",
+    "std::string_view",
+    None,
+    "int",
+    "unsigned long",
+    "long long",
+    "double",
+    "char",
+    "bool",
+]
+
+
+def generate(calls, args, seed=0x1a2ca7):
+    """Every call site uses its own variables and literals, as in real code, so that the compiler
+    cannot fold identical functions."""
+    rng = random.Random(seed * 1000003 + calls * 101 + args)
+    lines = ["#include <lazycat/lazycat.hpp>", "#include <string>", "#include <string_view>", ""]
+    for i in range(calls):
+        exprs = []
+        for j in range(args):
+            kind = rng.choice(ARGUMENT_KINDS)
+            if kind is None:
+                exprs.append(f'"literal {i}.{j}"')
+            else:
+                lines.append(f"extern {kind} v{i}_{j};")
+                exprs.append(f"v{i}_{j}")
+        lines.append(f"std::string f{i}() {{ return lazycat::cat({', '.join(exprs)}); }}")
+    return "\n".join(lines) + "\n"
+
+
+def compile_tu(compiler, flags, include, source, workdir, name):
+    src = os.path.join(workdir, name + ".cpp")
+    obj = os.path.join(workdir, name + ".o")
+    with open(src, "w", encoding="utf-8") as f:
+        f.write(source)
+    cmd = [compiler, *flags, "-I", include, "-c", src, "-o", obj]
+    start = time.perf_counter()
+    result = subprocess.run(cmd, capture_output=True, text=True, check=False)
+    elapsed = time.perf_counter() - start
+    if result.returncode != 0:
+        return None, None, result.stderr
+    return elapsed, os.path.getsize(obj), ""
+
+
+def best_of(repeat, *compile_args):
+    best = None
+    for _ in range(repeat):
+        elapsed, size, err = compile_tu(*compile_args)
+        if elapsed is None:
+            sys.exit(f"compilation failed:\n{err}")
+        best = elapsed if best is None else min(best, elapsed)
+    return best, size
+
+
+def parse_list(text):
+    return [int(x) for x in text.split(",") if x]
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--include", default=os.path.join(here, "..", "src"))
+    parser.add_argument("--flags", default="-O2 -std=c++20")
+    parser.add_argument("--calls", type=parse_list, default=[100, 500])
+    parser.add_argument("--args", type=parse_list, default=[2, 8, 16, 40])
+    parser.add_argument("--repeat", type=int, default=1, help="report the best of this many")
+    parser.add_argument("--json", help="also write the results to this file")
+    parser.add_argument("--depth-budget", type=int,
+                        help="fail if cat() of max(--args) arguments needs a deeper template depth")
+    args = parser.parse_args()
+    flags = shlex.split(args.flags)
+
+    results = []
+    with tempfile.TemporaryDirectory() as workdir:
+        base_time, base_size = best_of(args.repeat, args.compiler, flags, args.include,
+                                       generate(0, 0), workdir, "base")
+        print(f"include only: {base_time:.2f} s, {base_size} bytes")
+        print(f"{'calls':>6} {'args':>5} {'time (s)':>9} {'ms/call':>8} {'object (KiB)':>13}")
+        for calls in args.calls:
+            for nargs in args.args:
+                elapsed, size = best_of(args.repeat, args.compiler, flags, args.include,
+                                        generate(calls, nargs), workdir, f"tu_{calls}_{nargs}")
+                per_call = (elapsed - base_time) / calls * 1000
+                print(f"{calls:>6} {nargs:>5} {elapsed:>9.2f} {per_call:>8.2f} "
+                      f"{(size - base_size) / 1024:>13.1f}")
+                results.append({"calls": calls, "args": nargs, "seconds": elapsed,
+                                "ms_per_call": per_call, "object_bytes": size - base_size})
+
+        depth_ok = True
+        if args.depth_budget is not None:
+            nargs = max(args.args)
+            elapsed, _, err = compile_tu(args.compiler,
+                                         flags + [f"-ftemplate-depth={args.depth_budget}"],
+                                         args.include, generate(1, nargs), workdir, "depth")
+            depth_ok = elapsed is not None
+            status = "ok" if depth_ok else "EXCEEDED"
+            print(f"cat() of {nargs} arguments with -ftemplate-depth={args.depth_budget}: {status}")
+            if not depth_ok:
+                print(err[:2000], file=sys.stderr)
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump({"compiler": args.compiler, "flags": args.flags,
+                       "include_only": {"seconds": base_time, "object_bytes": base_size},
+                       "results": results}, f, indent=2)
+    return 0 if depth_ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <lazycat/lazycat.hpp>
+
+// Reports lazycat's instrumentation counters (see lazycat/instrumentation.hpp) as per-iteration
+// custom counters of a benchmark.  Call reset_instrumentation() before the benchmark loop and
+// report_instrumentation() after it.  Both do nothing unless built with LAZYCAT_INSTRUMENTATION,
+// as in lazycat_benchmark_instrumented.
+
+inline void reset_instrumentation() {
+    lazycat::instrumentation::reset();
+}
+
+inline void report_instrumentation(benchmark::State& state) {
+    if constexpr (lazycat::instrumentation::enabled) {
+        const auto stats = lazycat::instrumentation::snapshot();
+        if (stats.materializations == 0 && stats.appends == 0) return;  // lazycat was not used
+        std::uint64_t size_ns = 0, write_ns = 0;
+        for (const auto& w : stats.writers) {
+            size_ns += w.size_nanoseconds;
+            write_ns += w.write_nanoseconds;
+        }
+        const auto per_iteration = [](std::uint64_t value) {
+            return benchmark::Counter(static_cast<double>(value),
+                                      benchmark::Counter::kAvgIterations);
+        };
+        state.counters["materializations"] = per_iteration(stats.materializations);
+        state.counters["allocs"] = per_iteration(stats.allocations);
+        state.counters["alloc_bytes"] = per_iteration(stats.allocated_bytes);
+        state.counters["reallocs"] = per_iteration(stats.reallocations);
+        state.counters["size_ns"] = per_iteration(size_ns);
+        state.counters["write_ns"] = per_iteration(write_ns);
+    }
+}
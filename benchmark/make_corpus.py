@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Generates the benchmark corpus replayed by the Corpus_* benchmarks.
+
+Usage:
+    make_corpus.py [--records 4096] [--seed 1] > corpus/log_records.tsv
+
+Each line is one record: a template name and its fields, separated by tabs.  The templates are
+those of benchmark_corpus.cpp:
+
+    http    client_ip method path status bytes duration_ms
+    kv      level component user_id retries message
+    metric  name host value timestamp_ms
+    trade   order_id side quantity symbol price
+
+The values follow the shapes of real logs: short keys from small vocabularies, medium paths and
+messages, mostly-2xx statuses, log-normal sizes and latencies, 6 to 10 digit ids, 13 digit
+millisecond timestamps and prices with two decimals.
+"""
+
+import argparse
+import math
+import random
+import sys
+
+METHODS = ["GET"] * 8 + ["POST"] * 3 + ["PUT", "DELETE", "HEAD"]
+STATUSES = ([200] * 40 + [201, 204, 206] * 2 + [301, 302, 304] * 2 +
+            [400, 401, 403, 404, 404, 429] + [500, 502, 503])
+SEGMENTS = ["api", "v1", "v2", "users", "orders", "items", "search", "static", "img", "assets",
+            "checkout", "cart", "profile", "settings", "health", "metrics", "auth", "login"]
+LEVELS = ["INFO"] * 12 + ["DEBUG"] * 6 + ["WARN"] * 3 + ["ERROR"]
+COMPONENTS = ["db", "cache", "http", "scheduler", "auth", "billing", "queue", "storage", "gc"]
+WORDS = ["request", "completed", "failed", "retrying", "connection", "timeout", "user", "session",
+         "expired", "refreshed", "token", "cache", "miss", "hit", "query", "slow", "rows",
+         "returned", "lock", "acquired", "released", "after", "backoff", "upstream", "closed"]
+METRICS = ["cpu.load", "cpu.user", "mem.used", "mem.free", "disk.read", "disk.write",
+           "net.rx_bytes", "net.tx_bytes", "http.requests", "http.latency_p99", "gc.pause"]
+SYMBOLS = ["AAPL", "MSFT", "GOOG", "AMZN", "TSLA", "NVDA", "META", "BRK.B", "JPM", "V", "XOM"]
+
+
+def path(rng):
+    segments = [rng.choice(SEGMENTS) for _ in range(rng.randint(1, 5))]
+    if rng.random() < 0.5:
+        segments.append(str(rng.randint(1, 10 ** rng.randint(1, 8))))
+    ret = "/" + "/".join(segments)
+    if rng.random() < 0.2:
+        ret += "?page=%d&limit=%d" % (rng.randint(1, 50), rng.choice([10, 20, 50, 100]))
+    return ret
+
+
+def short_double(value, digits):
+    """The value rounded to a few significant digits, as a shortest round-trip string."""
+    return repr(float("%.*g" % (digits, value)))
+
+
+def record(rng, timestamp):
+    kind = rng.choices(["http", "kv", "metric", "trade"], weights=[4, 3, 2, 1])[0]
+    if kind == "http":
+        ip = "10.%d.%d.%d" % (rng.randint(0, 255), rng.randint(0, 255), rng.randint(1, 254))
+        size = int(rng.lognormvariate(7, 2))
+        duration = rng.lognormvariate(1, 1.5)
+        return [kind, ip, rng.choice(METHODS), path(rng), str(rng.choice(STATUSES)), str(size),
+                short_double(duration, rng.randint(2, 6))]
+    if kind == "kv":
+        message = " ".join(rng.choice(WORDS) for _ in range(rng.randint(2, 12)))
+        retries = 0 if rng.random() < 0.8 else rng.randint(1, 12)
+        user_id = rng.randint(10 ** 5, 10 ** rng.randint(6, 10))
+        return [kind, rng.choice(LEVELS), rng.choice(COMPONENTS), str(user_id), str(retries),
+                message]
+    if kind == "metric":
+        value = rng.lognormvariate(3, 3) if rng.random() < 0.7 else rng.random() * 100
+        host = "web-%02d" % rng.randint(1, 40)
+        return [kind, rng.choice(METRICS), host, short_double(value, rng.randint(3, 17)),
+                str(timestamp)]
+    quantity = int(math.ceil(rng.paretovariate(1.2) * 10))
+    price = round(rng.uniform(5, 900), 2)
+    return [kind, str(rng.randint(10 ** 9, 10 ** 10 - 1)), rng.choice(["BUY", "SELL"]),
+            str(quantity), rng.choice(SYMBOLS), repr(price)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--records", type=int, default=4096)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+    rng = random.Random(args.seed)
+    timestamp = 1700000000000
+    for _ in range(args.records):
+        timestamp += int(rng.expovariate(1 / 40))
+        sys.stdout.write("\t".join(record(rng, timestamp)) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define LAZYCAT_HAS_PERF_EVENTS
+#endif
+
+// Branch misses and cache misses of the calling thread, counted with perf_event_open on Linux.
+// Call start() before the benchmark loop, stop() after it, then report() with the number of items
+// (e.g. records) to divide by.  Counting is unavailable on other platforms, in virtual machines
+// without a PMU and when perf_event_paranoid forbids it; report() then adds no counters.
+
+class perf_counters {
+   public:
+    perf_counters() {
+#if defined(LAZYCAT_HAS_PERF_EVENTS)
+        fds_[0] = open_counter(PERF_COUNT_HW_BRANCH_MISSES);
+        fds_[1] = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+    }
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+    ~perf_counters() {
+#if defined(LAZYCAT_HAS_PERF_EVENTS)
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    void start() {
+#if defined(LAZYCAT_HAS_PERF_EVENTS)
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(LAZYCAT_HAS_PERF_EVENTS)
+        for (int i = 0; i != 2; ++i) {
+            if (fds_[i] < 0) continue;
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fds_[i], &values_[i], sizeof(values_[i])) != sizeof(values_[i])) {
+                close(fds_[i]);
+                fds_[i] = -1;
+            }
+        }
+#endif
+    }
+
+    // Adds the counters divided by items, e.g. "branch_misses" per record.
+    void report(benchmark::State& state, double items) const {
+        if (items <= 0) return;
+        if (fds_[0] >= 0) state.counters["branch_misses"] = static_cast<double>(values_[0]) / items;
+        if (fds_[1] >= 0) state.counters["cache_misses"] = static_cast<double>(values_[1]) / items;
+    }
+
+   private:
+#if defined(LAZYCAT_HAS_PERF_EVENTS)
+    static int open_counter(std::uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;  // allowed with the default perf_event_paranoid of 2
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    int fds_[2] = {-1, -1};
+    std::uint64_t values_[2] = {0, 0};
+};
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef LAZYCAT_INSTRUMENTATION
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#endif
+
+// Define LAZYCAT_INSTRUMENTATION to count materializations, allocations and reallocations, and to
+// measure the time spent in size() and write() of each writer type (default is off).  When it is
+// off, the hooks expand to the plain calls and instrumentation::snapshot() returns zeros, so code
+// that exports the stats compiles either way.  Every translation unit of a program must agree on
+// the macro.
+//
+// When it is on, each writer call in a cat() or append() reads the clock twice, so the absolute
+// times include the measurement overhead; they are meant for comparing writers with each other and
+// the size pass with the write pass.  Constant evaluation is never counted.  Nested catters are
+// not counted as writers themselves, since their own writers are.
+
+namespace lazycat {
+
+struct base_catter;
+
+namespace instrumentation {
+
+#ifdef LAZYCAT_INSTRUMENTATION
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+struct writer_stats {
+    std::string_view writer;  // the name of the writer type
+    std::uint64_t size_calls;
+    std::uint64_t size_nanoseconds;
+    std::uint64_t write_calls;
+    std::uint64_t write_nanoseconds;
+};
+
+struct stats {
+    std::uint64_t materializations;        // strings built by cat() (and dynamic_cat)
+    std::uint64_t appends;                 // append() calls
+    std::uint64_t allocations;             // materializations that did not fit in the SSO buffer
+    std::uint64_t allocated_bytes;         // bytes allocated by materializations and reallocations
+    std::uint64_t reallocations;           // appends that had to grow the destination
+    std::uint64_t size_pass_nanoseconds;   // in cat(), the size() pass over all writers
+    std::uint64_t write_pass_nanoseconds;  // in cat(), the write() pass over all writers
+    std::vector<writer_stats> writers;     // in the order that they were first used
+};
+
+}  // namespace instrumentation
+
+#ifdef LAZYCAT_INSTRUMENTATION
+
+namespace detail {
+
+// The name of T, e.g. "lazycat::integral_writer<int>" (compiler-specific spelling).
+template <typename T>
+constexpr std::string_view type_name() noexcept {
+#if defined(_MSC_VER)
+    constexpr std::string_view name = __FUNCSIG__;
+    constexpr size_t start = name.find("type_name<") + 10;
+    constexpr size_t end = name.rfind(">(void)");
+#else
+    constexpr std::string_view name = __PRETTY_FUNCTION__;  // "... [with T = X; ...]" or "[T = X]"
+    constexpr size_t start = name.find("T = ") + 4;
+    constexpr size_t end =
+        name.find(';', start) != std::string_view::npos ? name.find(';', start) : name.rfind(']');
+#endif
+    return name.substr(start, end - start);
+}
+
+struct writer_counters {
+    std::string_view name;
+    std::atomic<std::uint64_t> size_calls{0};
+    std::atomic<std::uint64_t> size_nanoseconds{0};
+    std::atomic<std::uint64_t> write_calls{0};
+    std::atomic<std::uint64_t> write_nanoseconds{0};
+    writer_counters* next = nullptr;
+};
+
+struct global_counters {
+    std::atomic<std::uint64_t> materializations{0};
+    std::atomic<std::uint64_t> appends{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocated_bytes{0};
+    std::atomic<std::uint64_t> reallocations{0};
+    std::atomic<std::uint64_t> size_pass_nanoseconds{0};
+    std::atomic<std::uint64_t> write_pass_nanoseconds{0};
+    std::atomic<writer_counters*> writers{nullptr};  // most recently registered first
+};
+
+inline global_counters& counters() noexcept {
+    static global_counters instance;
+    return instance;
+}
+
+// The counters of each writer type, registered on first use.
+template <typename Writer>
+inline writer_counters& counters_for() noexcept {
+    static writer_counters instance{type_name<Writer>()};
+    static const bool registered = [] {
+        std::atomic<writer_counters*>& head = counters().writers;
+        instance.next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(instance.next, &instance, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+        return true;
+    }();
+    (void)registered;
+    return instance;
+}
+
+inline void count(std::atomic<std::uint64_t>& counter, std::uint64_t value = 1) noexcept {
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+// Calls f(), adding the elapsed time to `nanoseconds` and one to `calls` (if given).
+template <typename F>
+constexpr auto measure(std::atomic<std::uint64_t>* calls,
+                       std::atomic<std::uint64_t>& nanoseconds,
+                       F&& f) noexcept {
+    if (std::is_constant_evaluated()) return f();
+    const auto start = std::chrono::steady_clock::now();
+    auto result = f();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    count(nanoseconds, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    if (calls) count(*calls);
+    return result;
+}
+
+template <typename Writer>
+constexpr size_t instrumented_size(const Writer& writer) noexcept {
+    if constexpr (std::is_base_of_v<base_catter, Writer>) {
+        return writer.size();
+    } else {
+        if (std::is_constant_evaluated()) return writer.size();
+        writer_counters& c = counters_for<Writer>();
+        return measure(&c.size_calls, c.size_nanoseconds, [&] { return writer.size(); });
+    }
+}
+
+template <typename Writer, typename CharT>
+constexpr CharT* instrumented_write(const Writer& writer, CharT* out) noexcept {
+    if constexpr (std::is_base_of_v<base_catter, Writer>) {
+        return writer.write(out);
+    } else {
+        if (std::is_constant_evaluated()) return writer.write(out);
+        writer_counters& c = counters_for<Writer>();
+        return measure(&c.write_calls, c.write_nanoseconds, [&] { return writer.write(out); });
+    }
+}
+
+template <typename CharT>
+constexpr void record_materialization(const std::basic_string<CharT>& s) noexcept {
+    if (std::is_constant_evaluated()) return;
+    count(counters().materializations);
+    if (s.capacity() > std::basic_string<CharT>().capacity()) {
+        count(counters().allocations);
+        count(counters().allocated_bytes, (s.capacity() + 1) * sizeof(CharT));
+    }
+}
+
+template <typename CharT>
+constexpr void record_append(const std::basic_string<CharT>& s, size_t old_capacity) noexcept {
+    if (std::is_constant_evaluated()) return;
+    count(counters().appends);
+    if (s.capacity() != old_capacity) {
+        count(counters().reallocations);
+        count(counters().allocated_bytes, (s.capacity() + 1) * sizeof(CharT));
+    }
+}
+
+}  // namespace detail
+
+namespace instrumentation {
+
+// Returns the current values of all counters.  Safe to call concurrently with cat() and append(),
+// but the values are not a consistent snapshot across counters.
+inline stats snapshot() {
+    const detail::global_counters& c = detail::counters();
+    stats ret{c.materializations.load(std::memory_order_relaxed),
+              c.appends.load(std::memory_order_relaxed),
+              c.allocations.load(std::memory_order_relaxed),
+              c.allocated_bytes.load(std::memory_order_relaxed),
+              c.reallocations.load(std::memory_order_relaxed),
+              c.size_pass_nanoseconds.load(std::memory_order_relaxed),
+              c.write_pass_nanoseconds.load(std::memory_order_relaxed),
+              {}};
+    for (const detail::writer_counters* w = c.writers.load(std::memory_order_acquire); w != nullptr;
+         w = w->next) {
+        ret.writers.push_back(writer_stats{w->name, w->size_calls.load(std::memory_order_relaxed),
+                                           w->size_nanoseconds.load(std::memory_order_relaxed),
+                                           w->write_calls.load(std::memory_order_relaxed),
+                                           w->write_nanoseconds.load(std::memory_order_relaxed)});
+    }
+    std::reverse(ret.writers.begin(), ret.writers.end());
+    return ret;
+}
+
+// Sets all counters to zero.  Writer types stay registered.
+inline void reset() noexcept {
+    detail::global_counters& c = detail::counters();
+    for (auto* counter : {&c.materializations, &c.appends, &c.allocations, &c.allocated_bytes,
+                          &c.reallocations, &c.size_pass_nanoseconds, &c.write_pass_nanoseconds}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+    for (detail::writer_counters* w = c.writers.load(std::memory_order_acquire); w != nullptr;
+         w = w->next) {
+        for (auto* counter :
+             {&w->size_calls, &w->size_nanoseconds, &w->write_calls, &w->write_nanoseconds}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // namespace instrumentation
+
+#define LAZYCAT_WRITER_SIZE(writer) ::lazycat::detail::instrumented_size(writer)
+#define LAZYCAT_WRITER_WRITE(writer, out) ::lazycat::detail::instrumented_write(writer, out)
+#define LAZYCAT_MEASURE_PASS(counter, expr)                                              \
+    ::lazycat::detail::measure(nullptr, ::lazycat::detail::counters().counter, [&]() { \
+        return expr;                                                                     \
+    })
+
+#else
+
+namespace instrumentation {
+
+inline stats snapshot() { return stats{}; }
+inline void reset() noexcept {}
+
+}  // namespace instrumentation
+
+#define LAZYCAT_WRITER_SIZE(writer) (writer).size()
+#define LAZYCAT_WRITER_WRITE(writer, out) (writer).write(out)
+#define LAZYCAT_MEASURE_PASS(counter, expr) (expr)
+
+#endif
+
+}  // namespace lazycat
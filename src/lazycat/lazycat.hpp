@@ -11,3 +11,36 @@
 
 // Writers for bool
 #include <lazycat/lazycat_bool.hpp>
+
+// Writers that transcode UTF-16/UTF-32 into UTF-8, and that validate UTF-8
+#include <lazycat/lazycat_unicode.hpp>
+
+// Compile-time strings (fixed_string, cat_array, static_cat)
+#include <lazycat/lazycat_static.hpp>
+
+// Conditional writers (when, either)
+#include <lazycat/lazycat_conditional.hpp>
+
+// Runtime-built writer lists (dynamic_cat)
+#include <lazycat/lazycat_dynamic.hpp>
+
+// Extension point for user-defined types, and the Writer concepts
+#include <lazycat/lazycat_extension.hpp>
+
+// Writers for timestamps and durations
+#include <lazycat/lazycat_chrono.hpp>
+
+// Writers for hex digests and UUIDs
+#include <lazycat/lazycat_hex.hpp>
+
+// Writers for IP addresses
+#include <lazycat/lazycat_ip.hpp>
+
+// Writers for repeated content (fill, repeat)
+#include <lazycat/lazycat_repeat.hpp>
+
+// Writers for human-readable numbers (grouped, bytes_iec, si_units)
+#include <lazycat/lazycat_units.hpp>
+
+// Hashing while materializing (hashed_build, crc32c)
+#include <lazycat/lazycat_hash.hpp>
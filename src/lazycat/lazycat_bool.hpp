@@ -9,14 +9,19 @@ namespace lazycat {
 struct bool_writer : public base_writer {
     bool content;
     constexpr size_t size() const noexcept { return 1; }
-    constexpr char* write(char* out) const noexcept {
-        *out++ = content ? '1' : '0';
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        *out++ = static_cast<CharT>(content ? '1' : '0');
         return out;
     }
 };
 
-template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
-constexpr auto operator<<(Catter c, bool curr) noexcept {
+// Only matches `bool` exactly, so that pointers (e.g. string literals) are not converted to bool.
+template <typename Catter,
+          typename T,
+          std::enable_if_t<std::is_base_of_v<base_catter, Catter> && std::is_same_v<T, bool>, int> =
+              0>
+constexpr auto operator<<(Catter c, T curr) noexcept {
     return c << bool_writer{{}, curr};
 }
 
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/lazycat_integral.hpp>
+#include <lazycat/util.hpp>
+#include <limits>
+
+// This file contains writers for timestamps and durations:
+//   iso8601(tp)         "2024-03-05T14:07:09Z"         (fixed size 20)
+//   rfc3339_micros(tp)  "2024-03-05T14:07:09.123456Z"  (fixed size 27)
+//   duration(d)         "[-]HH:MM:SS.nnnnnnnnn"        (hours have at least two digits)
+// Timestamps are always in UTC, and the year must be between 0000 and 9999.
+//
+// cached_iso8601(tp) and cached_rfc3339_micros(tp) produce the same output, but reuse the
+// formatted "YYYY-MM-DDTHH:MM:SS" prefix (kept in a thread-local cache) while the second has not
+// changed, which is the common case when logging many lines per second.
+
+namespace lazycat {
+
+namespace detail {
+
+struct civil_date {
+    std::int64_t year;
+    unsigned month;  // [1, 12]
+    unsigned day;    // [1, 31]
+};
+
+// Converts days since 1970-01-01 to a proleptic Gregorian date.
+// From Howard Hinnant's "chrono-Compatible Low-Level Date Algorithms".
+constexpr civil_date civil_from_days(std::int64_t z) noexcept {
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);                // [0, 146096]
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+    const unsigned mp = (5 * doy + 2) / 153;                                     // [0, 11]
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;                             // [1, 31]
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;                                // [1, 12]
+    return civil_date{static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+// Floor division, so that times before the epoch are handled correctly.
+constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b) noexcept {
+    return a / b - (a % b != 0 && (a % b < 0) != (b < 0));
+}
+
+constexpr size_t timestamp_prefix_size = 19;  // "YYYY-MM-DDTHH:MM:SS"
+
+// Writes "YYYY-MM-DDTHH:MM:SS" for the given number of seconds since the epoch.
+template <typename CharT>
+constexpr CharT* write_timestamp_prefix(CharT* out, std::int64_t epoch_seconds) noexcept {
+    const std::int64_t days = floor_div(epoch_seconds, 86400);
+    const unsigned secs_of_day = static_cast<unsigned>(epoch_seconds - days * 86400);
+    const civil_date date = civil_from_days(days);
+    const unsigned year = static_cast<unsigned>(date.year);
+    out = write_2_digits(out, year / 100 % 100);
+    out = write_2_digits(out, year % 100);
+    *out++ = static_cast<CharT>('-');
+    out = write_2_digits(out, date.month);
+    *out++ = static_cast<CharT>('-');
+    out = write_2_digits(out, date.day);
+    *out++ = static_cast<CharT>('T');
+    out = write_2_digits(out, secs_of_day / 3600);
+    *out++ = static_cast<CharT>(':');
+    out = write_2_digits(out, secs_of_day / 60 % 60);
+    *out++ = static_cast<CharT>(':');
+    out = write_2_digits(out, secs_of_day % 60);
+    return out;
+}
+
+struct timestamp_prefix_cache {
+    std::int64_t epoch_seconds = std::numeric_limits<std::int64_t>::min();
+    char prefix[timestamp_prefix_size];
+};
+
+inline const char* cached_timestamp_prefix(std::int64_t epoch_seconds) noexcept {
+    static thread_local timestamp_prefix_cache cache;
+    if (cache.epoch_seconds != epoch_seconds) {
+        write_timestamp_prefix(cache.prefix, epoch_seconds);
+        cache.epoch_seconds = epoch_seconds;
+    }
+    return cache.prefix;
+}
+
+template <bool Cached, typename CharT>
+inline LAZYCAT_FORCEINLINE CharT* write_timestamp_prefix_maybe_cached(
+    CharT* out,
+    std::int64_t epoch_seconds) noexcept {
+    if constexpr (Cached) {
+        return copy_chars(cached_timestamp_prefix(epoch_seconds), timestamp_prefix_size, out);
+    } else {
+        return write_timestamp_prefix(out, epoch_seconds);
+    }
+}
+
+// Writes val (which must be less than 10^Digits) as exactly Digits digits.
+template <size_t Digits, typename CharT>
+constexpr CharT* write_fixed_digits(CharT* out, std::uint32_t val) noexcept {
+    CharT* const end = out + Digits;
+    CharT* it = end;
+    for (size_t i = 0; i + 1 < Digits; i += 2) {
+        it -= 2;
+        write_2_digits(it, val % 100);
+        val /= 100;
+    }
+    if constexpr (Digits % 2 == 1) *--it = static_cast<CharT>('0' + val);
+    return end;
+}
+
+}  // namespace detail
+
+template <bool Cached = false>
+struct iso8601_writer : public base_writer {
+    std::int64_t epoch_seconds;
+    constexpr static size_t size() noexcept { return detail::timestamp_prefix_size + 1; }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        out = detail::write_timestamp_prefix_maybe_cached<Cached>(out, epoch_seconds);
+        *out++ = static_cast<CharT>('Z');
+        return out;
+    }
+};
+
+template <bool Cached = false>
+struct rfc3339_micros_writer : public base_writer {
+    std::int64_t epoch_micros;
+    constexpr static size_t size() noexcept { return detail::timestamp_prefix_size + 8; }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        const std::int64_t epoch_seconds = detail::floor_div(epoch_micros, 1000000);
+        out = detail::write_timestamp_prefix_maybe_cached<Cached>(out, epoch_seconds);
+        *out++ = static_cast<CharT>('.');
+        out = detail::write_fixed_digits<6>(
+            out, static_cast<std::uint32_t>(epoch_micros - epoch_seconds * 1000000));
+        *out++ = static_cast<CharT>('Z');
+        return out;
+    }
+};
+
+struct duration_writer : public base_writer {
+    std::int64_t nanoseconds;
+    constexpr std::uint64_t magnitude() const noexcept {
+        return nanoseconds < 0 ? -static_cast<std::uint64_t>(nanoseconds)
+                               : static_cast<std::uint64_t>(nanoseconds);
+    }
+    constexpr std::uint64_t hours() const noexcept { return magnitude() / 3600000000000ull; }
+    // The size only depends on the number of digits in the hours.
+    constexpr size_t size() const noexcept {
+        const std::uint64_t h = hours();
+        return (nanoseconds < 0) + (h < 10 ? 2 : detail::calculate_integral_size_unsigned<20>(h)) +
+               16;
+    }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        if (nanoseconds < 0) *out++ = static_cast<CharT>('-');
+        const std::uint64_t mag = magnitude();
+        const std::uint64_t h = mag / 3600000000000ull;
+        if (h < 10) {
+            out = detail::write_2_digits(out, static_cast<unsigned>(h));
+        } else {
+            out += detail::calculate_integral_size_unsigned<20>(h);
+            detail::write_integral_chars_unsigned(out, h);
+        }
+        const std::uint64_t rest = mag - h * 3600000000000ull;
+        const unsigned secs = static_cast<unsigned>(rest / 1000000000);
+        *out++ = static_cast<CharT>(':');
+        out = detail::write_2_digits(out, secs / 60);
+        *out++ = static_cast<CharT>(':');
+        out = detail::write_2_digits(out, secs % 60);
+        *out++ = static_cast<CharT>('.');
+        return detail::write_fixed_digits<9>(
+            out, static_cast<std::uint32_t>(rest - std::uint64_t{secs} * 1000000000));
+    }
+};
+
+template <typename Duration>
+[[nodiscard]] constexpr iso8601_writer<> iso8601(
+    std::chrono::time_point<std::chrono::system_clock, Duration> tp) noexcept {
+    return iso8601_writer<>{
+        {}, std::chrono::floor<std::chrono::seconds>(tp).time_since_epoch().count()};
+}
+
+template <typename Duration>
+[[nodiscard]] inline iso8601_writer<true> cached_iso8601(
+    std::chrono::time_point<std::chrono::system_clock, Duration> tp) noexcept {
+    return iso8601_writer<true>{
+        {}, std::chrono::floor<std::chrono::seconds>(tp).time_since_epoch().count()};
+}
+
+template <typename Duration>
+[[nodiscard]] constexpr rfc3339_micros_writer<> rfc3339_micros(
+    std::chrono::time_point<std::chrono::system_clock, Duration> tp) noexcept {
+    return rfc3339_micros_writer<>{
+        {}, std::chrono::floor<std::chrono::microseconds>(tp).time_since_epoch().count()};
+}
+
+template <typename Duration>
+[[nodiscard]] inline rfc3339_micros_writer<true> cached_rfc3339_micros(
+    std::chrono::time_point<std::chrono::system_clock, Duration> tp) noexcept {
+    return rfc3339_micros_writer<true>{
+        {}, std::chrono::floor<std::chrono::microseconds>(tp).time_since_epoch().count()};
+}
+
+template <typename Rep, typename Period>
+[[nodiscard]] constexpr duration_writer duration(std::chrono::duration<Rep, Period> d) noexcept {
+    return duration_writer{
+        {}, std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()};
+}
+
+}  // namespace lazycat
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <lazycat/lazycat_core.hpp>
+
+// This file contains writers for optional parts of an expression:
+//   when(cond, args...)  writes cat(args...) only if cond is true
+//   either(cond, a, b)   writes a if cond is true, otherwise b
+// The arguments can be anything that cat() accepts, including other catters.
+
+namespace lazycat {
+
+template <typename Writer>
+struct conditional_writer : public base_writer {
+    bool condition;
+    Writer writer;
+    constexpr size_t size() const noexcept { return condition ? writer.size() : 0; }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        return condition ? writer.write(out) : out;
+    }
+};
+
+template <typename TrueWriter, typename FalseWriter>
+struct either_writer : public base_writer {
+    bool condition;
+    TrueWriter true_writer;
+    FalseWriter false_writer;
+    constexpr size_t size() const noexcept {
+        return condition ? true_writer.size() : false_writer.size();
+    }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        return condition ? true_writer.write(out) : false_writer.write(out);
+    }
+};
+
+template <typename... Ss>
+[[nodiscard]] constexpr inline auto when(bool condition, Ss&&... ss) noexcept {
+    using Writer = decltype(cat(std::forward<Ss>(ss)...));
+    return conditional_writer<Writer>{{}, condition, cat(std::forward<Ss>(ss)...)};
+}
+
+template <typename T, typename F>
+[[nodiscard]] constexpr inline auto either(bool condition, T&& t, F&& f) noexcept {
+    using TrueWriter = decltype(cat(std::forward<T>(t)));
+    using FalseWriter = decltype(cat(std::forward<F>(f)));
+    return either_writer<TrueWriter, FalseWriter>{
+        {}, condition, cat(std::forward<T>(t)), cat(std::forward<F>(f))};
+}
+
+}  // namespace lazycat
@@ -4,6 +4,7 @@
 #include <lazycat/util.hpp>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace lazycat {
 
@@ -12,28 +13,90 @@ struct base_writer {};
 
 // A writer must have these functions:
 // size_t size();
-// char* write(char* out);
+// template <typename CharT> CharT* write(CharT* out);
 // constexprness, constness, and noexceptness is optional, but good to have.
 // size() will be called once, and then write() will be called once, so it is possible to generate
 // some cached value in size() (see lazycat_integral.hpp).  However, try to keep constructors and
 // destructors trivial.
+// size() is measured in code units of the output character type.  Writers that only produce ASCII
+// (e.g. numbers) should accept any CharT in write(), so that they can be used to build
+// std::wstring, std::u8string, std::u16string and std::u32string directly.
+
+namespace detail {
+
+// Passes the output [first, last) of one writer to an observer (see catter::write_observed).
+template <typename Observer, typename OutCharT>
+constexpr OutCharT* observed(Observer& observer, OutCharT* first, OutCharT* last) {
+    observer(first, last);
+    return last;
+}
+
+// The writers of a flat_catter or flat_appender.  Each writer is in its own base class, so that
+// (unlike std::tuple or a chain of combined_catters) the instantiation depth does not grow with
+// the number of writers.
+template <size_t I, typename Writer>
+struct writer_slot {
+    Writer writer;
+};
+
+template <typename Indices, typename... Writers>
+struct writer_slots;
+
+template <size_t... Is, typename... Writers>
+struct writer_slots<std::index_sequence<Is...>, Writers...> : public writer_slot<Is, Writers>... {
+    constexpr size_t size() const noexcept {
+        size_t sz = 0;
+        ((sz += LAZYCAT_WRITER_SIZE((static_cast<const writer_slot<Is, Writers>&>(*this).writer))),
+         ...);
+        return sz;
+    }
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        ((out = LAZYCAT_WRITER_WRITE((static_cast<const writer_slot<Is, Writers>&>(*this).writer),
+                                     out)),
+         ...);
+        return out;
+    }
+    template <typename OutCharT, typename Observer>
+    constexpr OutCharT* write_observed(OutCharT* out, Observer& observer) const {
+        ((out = observed(observer, out,
+                         LAZYCAT_WRITER_WRITE(
+                             (static_cast<const writer_slot<Is, Writers>&>(*this).writer), out))),
+         ...);
+        return out;
+    }
+};
+
+template <typename... Writers>
+using writer_list = writer_slots<std::index_sequence_for<Writers...>, Writers...>;
+
+}  // namespace detail
 
 // stuff for cat():
 
 template <typename Prev, typename Writer>
 struct combined_catter;
 
-template <typename Catter>
-struct catter : public base_catter {
+// A catter is also a writer, so it can be an argument to another cat() or append() without being
+// materialized first.  Its size() and write() are inlined into the parent, and it is written in the
+// parent's character type.  Catters also have write_observed(out, observer), which is write() but
+// calls observer(first, last) with the output of each writer right after writing it (see
+// lazycat_hash.hpp).
+template <typename Catter, typename CharT>
+struct catter : public base_catter, public base_writer {
+    using char_type = CharT;
+    using string_type = std::basic_string<CharT>;
     // Note: Somehow this function being non-noexcept makes it noticeably slower than Abseil on
     // MacOS Clang, but we do want allocation failure to throw an exception like usual.
-    LAZYCAT_CONSTEXPR_STRING operator std::string() const {
-        const size_t sz = static_cast<const Catter&>(*this).size();
-        std::string ret = detail::construct_default_init(sz);
-        static_cast<const Catter&>(*this).write(ret.data());
+    LAZYCAT_CONSTEXPR_STRING operator string_type() const {
+        const size_t sz =
+            LAZYCAT_MEASURE_PASS(size_pass_nanoseconds, static_cast<const Catter&>(*this).size());
+        string_type ret = detail::construct_default_init<CharT>(sz);
+        LAZYCAT_MEASURE_PASS(write_pass_nanoseconds,
+                             static_cast<const Catter&>(*this).write(ret.data()));
         return ret;
     }
-    LAZYCAT_CONSTEXPR_STRING std::string build() const { return *this; }
+    LAZYCAT_CONSTEXPR_STRING string_type build() const { return *this; }
     template <typename Writer, typename = std::enable_if_t<std::is_base_of_v<base_writer, Writer>>>
     constexpr auto operator<<(Writer writer) const noexcept {
         return combined_catter<Catter, Writer>{{}, static_cast<const Catter&>(*this), writer};
@@ -44,17 +107,49 @@ struct catter : public base_catter {
     }
 };
 
-struct empty_catter : public catter<empty_catter> {
+template <typename CharT = char>
+struct empty_catter : public catter<empty_catter<CharT>, CharT> {
     constexpr static size_t size() noexcept { return 0; }
-    constexpr static char* write(char* out) noexcept { return out; }
+    template <typename OutCharT>
+    constexpr static OutCharT* write(OutCharT* out) noexcept {
+        return out;
+    }
+    template <typename OutCharT, typename Observer>
+    constexpr static OutCharT* write_observed(OutCharT* out, Observer&) noexcept {
+        return out;
+    }
 };
 
 template <typename Prev, typename Writer>
-struct combined_catter : public catter<combined_catter<Prev, Writer>> {
+struct combined_catter : public catter<combined_catter<Prev, Writer>, typename Prev::char_type> {
     Prev prev;
     Writer writer;
-    constexpr size_t size() const noexcept { return prev.size() + writer.size(); }
-    constexpr char* write(char* out) const noexcept { return writer.write(prev.write(out)); }
+    constexpr size_t size() const noexcept { return prev.size() + LAZYCAT_WRITER_SIZE(writer); }
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        return LAZYCAT_WRITER_WRITE(writer, prev.write(out));
+    }
+    template <typename OutCharT, typename Observer>
+    constexpr OutCharT* write_observed(OutCharT* out, Observer& observer) const {
+        out = prev.write_observed(out, observer);
+        return detail::observed(observer, out, LAZYCAT_WRITER_WRITE(writer, out));
+    }
+};
+
+// The catter returned by cat(): all the writers at once, instead of one combined_catter per
+// argument.
+template <typename CharT, typename... Writers>
+struct flat_catter : public catter<flat_catter<CharT, Writers...>, CharT> {
+    detail::writer_list<Writers...> writers;
+    constexpr size_t size() const noexcept { return writers.size(); }
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        return writers.write(out);
+    }
+    template <typename OutCharT, typename Observer>
+    constexpr OutCharT* write_observed(OutCharT* out, Observer& observer) const {
+        return writers.write_observed(out, observer);
+    }
 };
 
 // stuff for append():
@@ -62,8 +157,9 @@ struct combined_catter : public catter<combined_catter<Prev, Writer>> {
 template <typename Prev, typename Writer>
 struct combined_appender;
 
-template <typename Appender>
+template <typename Appender, typename CharT>
 struct appender : public base_catter {
+    using char_type = CharT;
     constexpr void build() const { static_cast<const Appender&>(*this).resize_and_write(0); }
     template <typename Writer, typename = std::enable_if_t<std::is_base_of_v<base_writer, Writer>>>
     constexpr auto operator<<(Writer writer) const noexcept {
@@ -75,75 +171,196 @@ struct appender : public base_catter {
     }
 };
 
-struct empty_appender : public appender<empty_appender> {
-    std::string& content;
+template <typename CharT = char>
+struct empty_appender : public appender<empty_appender<CharT>, CharT> {
+    std::basic_string<CharT>& content;
     // Resizes the root string such that later we still can write `sz` bytes, then write everything
     // we need to write
-    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC char* resize_and_write(size_t sz) const {
+    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC CharT* resize_and_write(size_t sz) const {
         return detail::append_default_init(content, sz);
     }
-};  // namespace lazycat
+};
 
 template <typename Prev, typename Writer>
-struct combined_appender : public appender<combined_appender<Prev, Writer>> {
+struct combined_appender
+    : public appender<combined_appender<Prev, Writer>, typename Prev::char_type> {
     Prev prev;
     Writer writer;
-    constexpr char* resize_and_write(size_t sz) const {
-        return writer.write(prev.resize_and_write(writer.size() + sz));
+    constexpr typename Prev::char_type* resize_and_write(size_t sz) const {
+        return LAZYCAT_WRITER_WRITE(writer,
+                                    prev.resize_and_write(LAZYCAT_WRITER_SIZE(writer) + sz));
+    }
+};
+
+// The appender returned by append().
+template <typename CharT, typename... Writers>
+struct flat_appender : public appender<flat_appender<CharT, Writers...>, CharT> {
+    std::basic_string<CharT>& content;
+    detail::writer_list<Writers...> writers;
+    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC CharT* resize_and_write(size_t sz) const {
+        return writers.write(detail::append_default_init(content, writers.size() + sz));
     }
 };
 
 // helpers for each type:
 
-struct string_view_writer : public base_writer {
-    std::string_view content;
+// Writes a string view.  The output character type must be of the same width as CharT, or CharT
+// must be a narrow character type, in which case ASCII is widened and any other code unit is
+// written as U+FFFD (see detail::widen_chars).  Narrow strings given to a wide cat() are decoded
+// with basic_utf8_decoding_writer instead, so this only happens when a narrow catter is nested in
+// a wide one.
+template <typename CharT>
+struct basic_string_view_writer : public base_writer {
+    std::basic_string_view<CharT> content;
     constexpr size_t size() const noexcept { return content.size(); }
-#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
-    constexpr char* write(char* out) const noexcept {
-        if (std::is_constant_evaluated()) {
-            return std::copy(content.begin(), content.end(), out);
-        } else {
-            std::memcpy(out, content.data(), content.size());
-            return out + content.size();
-        }
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        return detail::copy_chars(content.data(), content.size(), out);
     }
-#else
-    char* write(char* out) const noexcept {
-        std::memcpy(out, content.data(), content.size());
-        return out + content.size();
+};
+
+using string_view_writer = basic_string_view_writer<char>;
+
+// Writes a narrow UTF-8 string view into UTF-16 (if OutCharT is two bytes wide) or UTF-32 (if it
+// is four bytes wide, e.g. char32_t, or wchar_t outside Windows).  Malformed input is replaced
+// with U+FFFD, as in validated_utf8().
+template <typename CharT, typename OutCharT>
+struct basic_utf8_decoding_writer : public base_writer {
+    std::basic_string_view<CharT> content;
+    constexpr size_t size() const noexcept {
+        return detail::utf8_decoded_length<OutCharT>(content.data(), content.size());
+    }
+    template <typename WriteCharT>
+    constexpr WriteCharT* write(WriteCharT* out) const noexcept {
+        static_assert(sizeof(WriteCharT) == sizeof(OutCharT),
+                      "The output must have the width that the writer was made for");
+        return detail::utf8_decode_chars(content.data(), content.size(), out);
     }
-#endif
 };
 
+namespace detail {
+// The writer for a string view argument: a plain copy, unless a narrow string is written into a
+// wider output, where it is decoded as UTF-8.
+template <typename OutCharT, typename CharT>
+constexpr auto make_string_view_writer(std::basic_string_view<CharT> content) noexcept {
+    if constexpr (sizeof(CharT) == 1 && sizeof(OutCharT) > 1) {
+        return basic_utf8_decoding_writer<CharT, OutCharT>{{}, content};
+    } else {
+        return basic_string_view_writer<CharT>{{}, content};
+    }
+}
+}  // namespace detail
+
 template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
 constexpr auto operator<<(Catter c, std::string_view curr) noexcept {
-    return c << string_view_writer{{}, curr};
+    return c << detail::make_string_view_writer<typename Catter::char_type>(curr);
+}
+
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+constexpr auto operator<<(Catter c, std::wstring_view curr) noexcept {
+    return c << basic_string_view_writer<wchar_t>{{}, curr};
+}
+
+#if defined(__cpp_char8_t)
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+constexpr auto operator<<(Catter c, std::u8string_view curr) noexcept {
+    return c << detail::make_string_view_writer<typename Catter::char_type>(curr);
 }
+#endif
 
-struct char_writer : public base_writer {
-    char content;
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+constexpr auto operator<<(Catter c, std::u16string_view curr) noexcept {
+    return c << basic_string_view_writer<char16_t>{{}, curr};
+}
+
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+constexpr auto operator<<(Catter c, std::u32string_view curr) noexcept {
+    return c << basic_string_view_writer<char32_t>{{}, curr};
+}
+
+// Writes a single character.  Same width rules as basic_string_view_writer: a narrow character
+// is a whole code point only if it is ASCII, so any other narrow character is widened to U+FFFD.
+template <typename CharT>
+struct basic_char_writer : public base_writer {
+    CharT content;
     constexpr size_t size() const noexcept { return 1; }
-    constexpr char* write(char* out) const noexcept {
-        *out++ = content;
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        static_assert(sizeof(CharT) == sizeof(OutCharT) || sizeof(CharT) == 1,
+                      "Only same-width copies and widening of narrow chars are supported");
+        if constexpr (sizeof(CharT) == sizeof(OutCharT)) {
+            *out++ = static_cast<OutCharT>(content);
+        } else {
+            *out++ = detail::widen_char<OutCharT>(content);
+        }
         return out;
     }
 };
 
+using char_writer = basic_char_writer<char>;
+
 template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
 [[nodiscard]] constexpr auto operator<<(Catter c, char curr) noexcept {
-    return c << char_writer{{}, curr};
+    return c << basic_char_writer<char>{{}, curr};
+}
+
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+[[nodiscard]] constexpr auto operator<<(Catter c, wchar_t curr) noexcept {
+    return c << basic_char_writer<wchar_t>{{}, curr};
+}
+
+#if defined(__cpp_char8_t)
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+[[nodiscard]] constexpr auto operator<<(Catter c, char8_t curr) noexcept {
+    return c << basic_char_writer<char8_t>{{}, curr};
+}
+#endif
+
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+[[nodiscard]] constexpr auto operator<<(Catter c, char16_t curr) noexcept {
+    return c << basic_char_writer<char16_t>{{}, curr};
+}
+
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+[[nodiscard]] constexpr auto operator<<(Catter c, char32_t curr) noexcept {
+    return c << basic_char_writer<char32_t>{{}, curr};
 }
 
 // main interface:
 
-template <typename... Ss>
+namespace detail {
+// Whether Catter is the empty catter followed by a single writer.
+template <typename Catter, typename CharT>
+inline constexpr bool is_single_writer_catter = false;
+template <typename Writer, typename CharT>
+inline constexpr bool is_single_writer_catter<combined_catter<empty_catter<CharT>, Writer>, CharT> =
+    true;
+
+// The writer for an argument of cat() or append(), as chosen by the operator<< overloads.  This
+// always starts from the empty catter, so the compiler resolves the overloads once per argument
+// type instead of once per argument position of every call site.  An overload may add several
+// writers (e.g. `return c << p.x << ',' << p.y;`), and then the whole catter is the writer.
+template <typename CharT, typename S>
+constexpr auto make_writer(const S& s) noexcept {
+    if constexpr (is_single_writer_catter<decltype(empty_catter<CharT>{} << s), CharT>) {
+        return (empty_catter<CharT>{} << s).writer;
+    } else {
+        return empty_catter<CharT>{} << s;
+    }
+}
+}  // namespace detail
+
+// cat<CharT>(...) materializes into std::basic_string<CharT> (default is std::string).
+template <typename CharT = char, typename... Ss>
 [[nodiscard]] constexpr inline auto cat(Ss&&... ss) noexcept {
-    return (empty_catter{} << ... << ss);
+    return flat_catter<CharT, decltype(detail::make_writer<CharT>(ss))...>{
+        {}, {{detail::make_writer<CharT>(ss)}...}};
 }
 
-template <typename... Ss>
-[[nodiscard]] constexpr inline auto append(std::string& str, Ss&&... ss) noexcept {
-    return (empty_appender{{}, str} << ... << ss);
+template <typename CharT, typename... Ss>
+[[nodiscard]] constexpr inline auto append(std::basic_string<CharT>& str, Ss&&... ss) noexcept {
+    return flat_appender<CharT, decltype(detail::make_writer<CharT>(ss))...>{
+        {}, str, {{detail::make_writer<CharT>(ss)}...}};
 }
 
 }  // namespace lazycat
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <lazycat/lazycat_bool.hpp>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/lazycat_floating_point.hpp>
+#include <lazycat/lazycat_integral.hpp>
+#include <lazycat/lazycat_ring.hpp>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// This file contains deferred_sink, which moves the formatting of a cat() expression off the
+// calling thread:
+//
+//   lazycat::deferred_sink sink(1 << 20);
+//   // latency-critical threads:
+//   sink.capture("order ", id, " filled at ", price, " x ", quantity, '\n');
+//   // background worker:
+//   sink.drain_to(file);
+//
+// capture() copies the raw arguments (integers, floating point numbers, narrow chars and bools as
+// they are, strings as a length followed by a copy of their characters) into a ring_sink record,
+// next to a pointer to a decoder instantiated for exactly those argument types.  drain() decodes
+// each record and runs the usual size()/write() formatting, so the output is the same as cat()
+// with the same arguments.  Arguments of other types are rejected at compile time, because they
+// may refer to memory that does not outlive the capture, or (wide chars) cannot be written by
+// cat<char>.
+
+namespace lazycat {
+
+namespace detail {
+
+// Character types wider than char, which cat<char> cannot write.
+template <typename T>
+inline constexpr bool is_wide_char_v = std::is_same_v<T, wchar_t> ||
+                                       std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
+// How an argument of type T is stored in a capture.  Arithmetic types (except wide chars) are
+// stored as they are, and anything that converts to std::string_view as a length and a copy of the
+// characters.
+template <typename T, typename = void>
+struct capture_traits;
+
+template <typename T>
+struct capture_traits<T, std::enable_if_t<std::is_arithmetic_v<T> && !is_wide_char_v<T>>> {
+    using type = T;
+    static constexpr bool fits(T) noexcept { return true; }
+    static size_t size(T) noexcept { return sizeof(T); }
+    static char* encode(char* out, T value) noexcept {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+    static T decode(const char*& in) noexcept {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+};
+
+template <typename T>
+struct capture_traits<T, std::enable_if_t<!std::is_arithmetic_v<T> &&
+                                          std::is_convertible_v<const T&, std::string_view>>> {
+    using type = std::string_view;
+    // The length is stored in 32 bits
+    static constexpr bool fits(std::string_view value) noexcept {
+        return value.size() <= std::numeric_limits<std::uint32_t>::max();
+    }
+    static size_t size(std::string_view value) noexcept {
+        return sizeof(std::uint32_t) + value.size();
+    }
+    static char* encode(char* out, std::string_view value) noexcept {
+        const auto length = static_cast<std::uint32_t>(value.size());
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), value.data(), value.size());
+        return out + sizeof(length) + value.size();
+    }
+    static std::string_view decode(const char*& in) noexcept {
+        std::uint32_t length;
+        std::memcpy(&length, in, sizeof(length));
+        const std::string_view value(in + sizeof(length), length);
+        in += sizeof(length) + length;
+        return value;
+    }
+};
+
+template <typename T, typename = void>
+struct is_capturable : std::false_type {};
+template <typename T>
+struct is_capturable<T, std::void_t<typename capture_traits<T>::type>> : std::true_type {};
+
+using deferred_formatter = void (*)(const char*, std::string&);
+
+// Decodes arguments stored as Ts... (left to right, as guaranteed by braced initialization) and
+// formats them into out.  Ts... are the capture_traits types, so that for example string literals
+// of different lengths share an instantiation.
+template <typename... Ts>
+void format_capture([[maybe_unused]] const char* in, std::string& out) {
+    const std::tuple<Ts...> args{capture_traits<Ts>::decode(in)...};
+    out.clear();
+    std::apply([&out](const auto&... as) { append(out, as...).build(); }, args);
+}
+
+}  // namespace detail
+
+class deferred_sink {
+   public:
+    explicit deferred_sink(size_t capacity) : ring_(capacity) {}
+
+    // Captures the arguments of a cat() expression, waiting if the ring is full.  Returns false if
+    // the capture is larger than the ring can hold, or if a string is 4 GiB or longer.
+    template <typename... Ss>
+    bool capture(const Ss&... ss) noexcept {
+        static_assert((detail::is_capturable<Ss>::value && ...),
+                      "deferred_sink can only capture arithmetic types (except wide chars) and "
+                      "strings");
+        if (!(detail::capture_traits<Ss>::fits(ss) && ...)) return false;
+        const size_t size =
+            sizeof(detail::deferred_formatter) + (detail::capture_traits<Ss>::size(ss) + ... + 0);
+        const ring_sink::reservation r = ring_.reserve(size);
+        if (!r.data) return false;
+        const detail::deferred_formatter formatter =
+            &detail::format_capture<typename detail::capture_traits<Ss>::type...>;
+        std::memcpy(r.data, &formatter, sizeof(formatter));
+        [[maybe_unused]] char* out = r.data + sizeof(formatter);
+        ((out = detail::capture_traits<Ss>::encode(out, ss)), ...);
+        ring_.commit(r);
+        return true;
+    }
+
+    // Formats the captured expressions in order, and calls f(std::string_view) with each result,
+    // until it reaches one that is not committed yet.  Returns the number of expressions.  Only
+    // one thread may drain at a time.
+    template <typename F>
+    size_t drain(F&& f) {
+        return ring_.drain([this, &f](std::string_view record) {
+            detail::deferred_formatter formatter;
+            std::memcpy(&formatter, record.data(), sizeof(formatter));
+            formatter(record.data() + sizeof(formatter), scratch_);
+            f(std::string_view(scratch_));
+        });
+    }
+
+    // Formats all captured expressions into `file`.
+    size_t drain_to(std::FILE* file) {
+        return drain([file](std::string_view message) {
+            std::fwrite(message.data(), 1, message.size(), file);
+        });
+    }
+
+   private:
+    ring_sink ring_;
+    std::string scratch_;  // reused by drain(), so that formatting does not allocate
+};
+
+}  // namespace lazycat
@@ -0,0 +1,187 @@
+#pragma once
+
+// LAZYCAT_HAS_ZLIB is defined by the lazycat_deflate CMake target, which links zlib and is only
+// defined when zlib is found (otherwise define it and link zlib yourself).
+#if defined(LAZYCAT_HAS_ZLIB)
+
+#include <cstddef>
+#include <lazycat/lazycat_core.hpp>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <zlib.h>
+
+// This file contains deflate_sink, which compresses cat() records as they are produced, so that a
+// large batch of text never sits uncompressed in memory:
+//
+//   lazycat::deflate_sink out([&](std::string_view chunk) { socket.send(chunk); });
+//   if (!out.is_open()) ...;  // out.error() is the zlib error code
+//   for (const auto& row : rows) lazycat::cat_into(out, row.id, ',', row.name, '\n');
+//   out.finish();  // compresses the rest and writes the gzip trailer
+//
+// Call finish() explicitly: the destructor finishes an unfinished stream too, but it ignores
+// failures, and exceptions thrown by the output function (which would otherwise terminate).
+//
+// Records are written straight into a fixed staging buffer (using size(), like the other sinks),
+// and the staging buffer is fed to zlib whenever the next record does not fit.  Compressed output
+// is passed to the output function in chunks of at most the staging size.  A record larger than
+// the staging buffer is written into a temporary buffer of its own size.
+
+namespace lazycat {
+
+enum class deflate_format {
+    gzip,  // gzip header and trailer (e.g. for .gz files and Content-Encoding: gzip)
+    zlib,  // zlib header and trailer
+    raw,   // no header or trailer
+};
+
+// Output is called with each std::string_view chunk of compressed data.
+template <typename Output>
+class deflate_sink {
+   public:
+    // zlib counts in uInt, which may be narrower than size_t, so larger staging sizes are clamped
+    constexpr static size_t max_staging_size = size_t{1} << 30;
+    static_assert(max_staging_size <= std::numeric_limits<uInt>::max());
+
+    // level is a zlib compression level (0 to 9, or Z_DEFAULT_COMPRESSION).  staging_size is
+    // clamped to [1, max_staging_size].  Check is_open() for failure.
+    explicit deflate_sink(Output output,
+                          int level = Z_DEFAULT_COMPRESSION,
+                          deflate_format format = deflate_format::gzip,
+                          size_t staging_size = size_t{64} << 10)
+        : output_(std::move(output)),
+          staging_size_(staging_size == 0                   ? 1
+                        : staging_size < max_staging_size ? staging_size
+                                                          : max_staging_size),
+          staging_(std::make_unique<char[]>(staging_size_)),
+          compressed_(std::make_unique<char[]>(staging_size_)) {
+        const int window_bits =
+            format == deflate_format::gzip ? 15 + 16 : format == deflate_format::zlib ? 15 : -15;
+        error_ = deflateInit2(&stream_, level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY);
+        open_ = error_ == Z_OK;
+    }
+    deflate_sink(const deflate_sink&) = delete;
+    deflate_sink& operator=(const deflate_sink&) = delete;
+    ~deflate_sink() {
+#if defined(__cpp_exceptions)
+        try {
+            finish();
+        } catch (...) {
+            end();
+        }
+#else
+        finish();
+#endif
+    }
+
+    bool is_open() const noexcept { return open_; }
+    // The zlib error code of the last failure, or Z_OK.
+    int error() const noexcept { return error_; }
+    // The number of bytes written and the number of compressed bytes output so far (not counting
+    // staged bytes that have not been compressed yet).
+    size_t bytes_in() const noexcept { return static_cast<size_t>(stream_.total_in) + staged_; }
+    size_t bytes_out() const noexcept { return static_cast<size_t>(stream_.total_out); }
+
+    // Returns a pointer to `n` writable bytes, or nullptr on failure.  The bytes are added to the
+    // stream with commit(n).
+    char* reserve(size_t n) {
+        if (!open_ || error_ != Z_OK) return nullptr;
+        if (n > staging_size_ - staged_) {
+            if (!compress(staging_.get(), staged_, Z_NO_FLUSH)) return nullptr;
+            staged_ = 0;
+            if (n > staging_size_) {
+                large_.resize(n);
+                return large_.data();
+            }
+        }
+        return staging_.get() + staged_;
+    }
+
+    void commit(size_t n) {
+        if (n > staging_size_) {
+            compress(large_.data(), n, Z_NO_FLUSH);
+            std::string().swap(large_);
+        } else {
+            staged_ += n;
+        }
+    }
+
+    // Compresses the staged bytes and flushes the compressor, so that everything written so far
+    // can be decompressed by the receiver (at some cost in compression ratio).
+    bool flush() {
+        if (!open_ || !compress(staging_.get(), staged_, Z_SYNC_FLUSH)) return false;
+        staged_ = 0;
+        return true;
+    }
+
+    // Compresses the rest, writes the trailer and releases the compressor.  Returns false on
+    // failure.
+    bool finish() {
+        if (!open_) return error_ == Z_OK;
+        const bool ok = compress(staging_.get(), staged_, Z_FINISH);
+        staged_ = 0;
+        end();
+        return ok;
+    }
+
+   private:
+    bool compress(const char* data, size_t size, int mode) {
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        for (;;) {
+            const size_t chunk = size < max_staging_size ? size : max_staging_size;
+            stream_.avail_in = static_cast<uInt>(chunk);
+            size -= chunk;
+            const int chunk_mode = size == 0 ? mode : Z_NO_FLUSH;
+            int ret;
+            do {
+                stream_.next_out = reinterpret_cast<Bytef*>(compressed_.get());
+                stream_.avail_out = static_cast<uInt>(staging_size_);
+                ret = deflate(&stream_, chunk_mode);
+                if (ret == Z_STREAM_ERROR) return fail(ret);
+                const size_t produced = staging_size_ - stream_.avail_out;
+                if (produced != 0) output_(std::string_view(compressed_.get(), produced));
+            } while (stream_.avail_out == 0 || (chunk_mode == Z_FINISH && ret != Z_STREAM_END));
+            if (size == 0) return true;
+        }
+    }
+
+    // Releases the compressor.
+    void end() noexcept {
+        if (!open_) return;
+        deflateEnd(&stream_);
+        open_ = false;
+    }
+
+    bool fail(int ret) noexcept {
+        error_ = ret;
+        return false;
+    }
+
+    Output output_;
+    size_t staging_size_;
+    std::unique_ptr<char[]> staging_;
+    std::unique_ptr<char[]> compressed_;
+    size_t staged_ = 0;
+    std::string large_;  // a record larger than the staging buffer
+    z_stream stream_{};
+    int error_ = Z_OK;
+    bool open_ = false;
+};
+
+// Appends the concatenation of ss... to the compressed stream.  Returns false on failure.
+template <typename Output, typename... Ss>
+bool cat_into(deflate_sink<Output>& sink, Ss&&... ss) {
+    const auto c = cat(std::forward<Ss>(ss)...);
+    const size_t sz = c.size();
+    char* const out = sink.reserve(sz);
+    if (!out) return false;
+    c.write(out);
+    sink.commit(sz);
+    return true;
+}
+
+}  // namespace lazycat
+
+#endif
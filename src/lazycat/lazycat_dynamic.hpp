@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <lazycat/lazycat_core.hpp>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// This file contains dynamic_cat, a runtime-built list of writers for messages whose parts are
+// only known at runtime.  Like cat(), it holds references to its arguments, and materializes with
+// a size pass, a single allocation, and a write pass.
+//
+// Writers are stored by value in a small-buffer arena, each preceded by a pointer to a table of
+// function pointers for its size() and write().  Writers must be trivially copyable and trivially
+// destructible (which all the writers in this library are), so the arena never has to run
+// constructors or destructors when it grows.
+//
+// Example:
+//   lazycat::dynamic_cat msg;
+//   msg << "query=" << query;
+//   if (log_time) msg << " time=" << elapsed_ms << "ms";
+//   std::string line = msg.build();
+
+namespace lazycat {
+
+namespace detail {
+
+template <typename CharT>
+struct dynamic_writer_vtable {
+    size_t (*size)(const void*) noexcept;
+    CharT* (*write)(const void*, CharT*) noexcept;
+    size_t object_size;
+    size_t object_align;
+};
+
+template <typename Writer, typename CharT>
+inline constexpr dynamic_writer_vtable<CharT> dynamic_writer_vtable_for = {
+    [](const void* writer) noexcept -> size_t {
+        return static_cast<const Writer*>(writer)->size();
+    },
+    [](const void* writer, CharT* out) noexcept -> CharT* {
+        return static_cast<const Writer*>(writer)->write(out);
+    },
+    sizeof(Writer),
+    alignof(Writer)};
+
+constexpr size_t align_up(size_t offset, size_t alignment) noexcept {
+    return (offset + (alignment - 1)) & ~(alignment - 1);
+}
+
+}  // namespace detail
+
+template <typename CharT = char, size_t InlineCapacity = 256>
+class basic_dynamic_cat {
+   public:
+    using char_type = CharT;
+    using string_type = std::basic_string<CharT>;
+
+    basic_dynamic_cat() noexcept = default;
+    basic_dynamic_cat(const basic_dynamic_cat&) = delete;
+    basic_dynamic_cat& operator=(const basic_dynamic_cat&) = delete;
+    basic_dynamic_cat(basic_dynamic_cat&& other) noexcept { take(other); }
+    basic_dynamic_cat& operator=(basic_dynamic_cat&& other) noexcept {
+        if (this != &other) {
+            heap_.reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    // Adds anything that cat() accepts (including writers and catters).
+    template <typename S>
+    basic_dynamic_cat& operator<<(S&& s) {
+        push(lazycat::cat<CharT>(std::forward<S>(s)));
+        return *this;
+    }
+    template <typename... Ss>
+    basic_dynamic_cat& add(Ss&&... ss) {
+        (*this << ... << std::forward<Ss>(ss));
+        return *this;
+    }
+
+    bool empty() const noexcept { return used_ == 0; }
+    void clear() noexcept { used_ = 0; }
+
+    size_t size() const noexcept {
+        size_t sz = 0;
+        for_each([&sz](const vtable* vt, const void* writer) { sz += vt->size(writer); });
+        return sz;
+    }
+    // Must be called after size(), as with any other writer.
+    CharT* write(CharT* out) const noexcept {
+        for_each([&out](const vtable* vt, const void* writer) { out = vt->write(writer, out); });
+        return out;
+    }
+
+    operator string_type() const {
+        const size_t sz = size();
+        string_type ret = detail::construct_default_init<CharT>(sz);
+        write(ret.data());
+        return ret;
+    }
+    string_type build() const { return *this; }
+    // Appends to `str`, with at most one reallocation.
+    void append_to(string_type& str) const { write(detail::append_default_init(str, size())); }
+
+   private:
+    using vtable = detail::dynamic_writer_vtable<CharT>;
+    using storage_unit = std::max_align_t;
+
+    template <typename Writer>
+    void push(const Writer& writer) {
+        static_assert(std::is_trivially_copyable_v<Writer> &&
+                          std::is_trivially_destructible_v<Writer>,
+                      "Writers stored in dynamic_cat must be trivially copyable and destructible");
+        static_assert(alignof(Writer) <= alignof(storage_unit), "Writer is overaligned");
+        const size_t header = detail::align_up(used_, alignof(const vtable*));
+        const size_t object = detail::align_up(header + sizeof(const vtable*), alignof(Writer));
+        const size_t end = object + sizeof(Writer);
+        if (end > capacity_) grow(end);
+        const vtable* const vt = &detail::dynamic_writer_vtable_for<Writer, CharT>;
+        std::memcpy(data_ + header, &vt, sizeof(vt));
+        ::new (static_cast<void*>(data_ + object)) Writer(writer);
+        used_ = end;
+    }
+
+    template <typename Func>
+    void for_each(Func&& func) const noexcept {
+        for (size_t pos = 0; pos != used_;) {
+            pos = detail::align_up(pos, alignof(const vtable*));
+            const vtable* vt;
+            std::memcpy(&vt, data_ + pos, sizeof(vt));
+            pos = detail::align_up(pos + sizeof(const vtable*), vt->object_align);
+            func(vt, static_cast<const void*>(data_ + pos));
+            pos += vt->object_size;
+        }
+    }
+
+    void grow(size_t min_capacity) {
+        const size_t new_capacity =
+            detail::align_up(std::max(min_capacity, capacity_ * 2), sizeof(storage_unit));
+        std::unique_ptr<storage_unit[]> new_heap(new storage_unit[new_capacity /
+                                                                  sizeof(storage_unit)]);
+        std::byte* const new_data = reinterpret_cast<std::byte*>(new_heap.get());
+        std::memcpy(new_data, data_, used_);
+        heap_ = std::move(new_heap);
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    void take(basic_dynamic_cat& other) noexcept {
+        if (other.heap_) {
+            heap_ = std::move(other.heap_);
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+        } else {
+            data_ = reinterpret_cast<std::byte*>(inline_buffer_);
+            capacity_ = sizeof(inline_buffer_);
+            std::memcpy(data_, other.data_, other.used_);
+        }
+        used_ = other.used_;
+        other.data_ = reinterpret_cast<std::byte*>(other.inline_buffer_);
+        other.capacity_ = sizeof(other.inline_buffer_);
+        other.used_ = 0;
+    }
+
+    storage_unit inline_buffer_[(InlineCapacity + sizeof(storage_unit) - 1) /
+                                sizeof(storage_unit)];
+    std::unique_ptr<storage_unit[]> heap_;
+    std::byte* data_ = reinterpret_cast<std::byte*>(inline_buffer_);
+    size_t used_ = 0;
+    size_t capacity_ = sizeof(inline_buffer_);
+};
+
+using dynamic_cat = basic_dynamic_cat<char>;
+using wdynamic_cat = basic_dynamic_cat<wchar_t>;
+
+}  // namespace lazycat
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/util.hpp>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#if defined(__cpp_concepts)
+#include <concepts>
+#endif
+
+// This file contains the extension point for user-defined types.  There are three ways to make
+// cat() accept a type T, in order of priority:
+//
+// 1) Specialize lazycat::writer_traits<T> with a static make_writer(const T&) function:
+//      template <>
+//      struct lazycat::writer_traits<point> {
+//          static constexpr auto make_writer(const point& p) noexcept {
+//              return lazycat::cat('(', p.x, ", ", p.y, ')');
+//          }
+//      };
+//
+// 2) Provide a lazycat_writer(const T&) function that can be found by ADL:
+//      namespace geo {
+//      constexpr auto lazycat_writer(const point& p) noexcept {
+//          return lazycat::cat(p.x, ',', p.y);
+//      }
+//      }
+//
+// 3) Provide a to_chars(char* first, char* last, const T&) function that can be found by ADL and
+//    returns something with a `ptr` member (like std::to_chars_result).  The output is formatted
+//    into a buffer of lazycat::to_chars_buffer_size<T> chars (which can be specialized) when the
+//    writer is made.
+//
+// make_writer() and lazycat_writer() must return a writer; a catter is a writer too.
+
+namespace lazycat {
+
+template <typename T, typename = void>
+struct writer_traits {};
+
+template <typename T>
+inline constexpr size_t to_chars_buffer_size = 128;
+
+namespace detail {
+
+template <typename T, typename = void>
+struct has_writer_traits : std::false_type {};
+template <typename T>
+struct has_writer_traits<
+    T,
+    void_t<decltype(writer_traits<T>::make_writer(std::declval<const T&>()))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct has_adl_writer : std::false_type {};
+template <typename T>
+struct has_adl_writer<T, void_t<decltype(lazycat_writer(std::declval<const T&>()))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct has_adl_to_chars : std::false_type {};
+template <typename T>
+struct has_adl_to_chars<T,
+                        void_t<decltype(to_chars(std::declval<char*>(),
+                                                 std::declval<char*>(),
+                                                 std::declval<const T&>())
+                                            .ptr)>> : std::true_type {};
+
+template <typename R, typename = void>
+struct has_error_code : std::false_type {};
+template <typename R>
+struct has_error_code<R, void_t<decltype(std::declval<const R&>().ec)>> : std::true_type {};
+
+// Types that the built-in overloads already handle.  These never use the extension point, so that
+// (for example) a to_chars() found by ADL in namespace std cannot take over.
+template <typename T>
+inline constexpr bool has_builtin_writer =
+    std::is_arithmetic_v<T> || std::is_base_of_v<base_writer, T> ||
+    std::is_base_of_v<base_catter, T> || std::is_convertible_v<const T&, std::string_view> ||
+    std::is_convertible_v<const T&, std::wstring_view> ||
+#if defined(__cpp_char8_t)
+    std::is_convertible_v<const T&, std::u8string_view> ||
+#endif
+    std::is_convertible_v<const T&, std::u16string_view> ||
+    std::is_convertible_v<const T&, std::u32string_view>;
+
+template <typename T>
+inline constexpr bool has_custom_writer =
+    !has_builtin_writer<T> &&
+    (has_writer_traits<T>::value || has_adl_writer<T>::value || has_adl_to_chars<T>::value);
+
+}  // namespace detail
+
+// Writer for types with a to_chars() hook.  The value is formatted when the writer is made, so the
+// writer does not refer to it.  If the hook fails (its result has an `ec` member that is not
+// std::errc{}), nothing is written.
+template <typename T>
+struct to_chars_writer : public base_writer {
+    char buffer[to_chars_buffer_size<T>];
+    size_t length = 0;
+    constexpr to_chars_writer() noexcept = default;
+    constexpr explicit to_chars_writer(const T& t) noexcept {
+        const auto result = to_chars(buffer, buffer + to_chars_buffer_size<T>, t);
+        if constexpr (detail::has_error_code<decltype(result)>::value) {
+            if (result.ec != std::errc{}) return;
+        }
+        length = static_cast<size_t>(result.ptr - buffer);
+    }
+    constexpr size_t size() const noexcept { return length; }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        return detail::copy_chars(buffer, length, out);
+    }
+};
+
+namespace detail {
+template <typename T>
+constexpr auto make_custom_writer(const T& t) noexcept {
+    if constexpr (has_writer_traits<T>::value) {
+        return writer_traits<T>::make_writer(t);
+    } else if constexpr (has_adl_writer<T>::value) {
+        return lazycat_writer(t);
+    } else {
+        return to_chars_writer<T>(t);
+    }
+}
+}  // namespace detail
+
+template <typename Catter,
+          typename T,
+          typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter> &&
+                                      detail::has_custom_writer<T>>>
+constexpr auto operator<<(Catter c, const T& curr) noexcept {
+    using Writer = decltype(detail::make_custom_writer(curr));
+    static_assert(std::is_base_of_v<base_writer, Writer>,
+                  "The extension point for this type must return a writer");
+    return c << detail::make_custom_writer(curr);
+}
+
+#if defined(__cpp_concepts)
+// Checks the writer protocol (see lazycat_core.hpp).
+template <typename W>
+concept Writer = std::is_base_of_v<base_writer, W> && requires(const W& w, char* out) {
+    { w.size() } -> std::convertible_to<size_t>;
+    { w.write(out) } -> std::same_as<char*>;
+};
+
+// A writer whose size() can be evaluated at compile time (checked on a value-initialized writer).
+template <typename W>
+concept ConstexprWriter = Writer<W> && std::default_initializable<W> && requires {
+    typename std::integral_constant<size_t, W{}.size()>;
+};
+
+// Anything that can be passed to cat().
+template <typename T>
+concept Writable = requires(const T& t) {
+    { empty_catter<>{} << t } -> Writer;
+};
+#endif
+
+}  // namespace lazycat
@@ -1,16 +1,29 @@
 #pragma once
 
+#include <bit>
 #if __has_include(<charconv>)
 #include <charconv>
 #endif
 #if !(defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L)
 #include <cstdio>
 #endif
+#include <cstdint>
 #include <lazycat/lazycat_core.hpp>
+#include <limits>
+#include <type_traits>
 
 // This file contains the writer for floating point types.  It simply calls std::to_chars (which
 // hopefully uses something fast like Ryu).  If std::to_chars is not available, then it falls back
 // on std::sprintf("%g") (which is not exactly equivalent to std::to_chars).
+//
+// Neither can be constant evaluated, so in constant evaluation (see lazycat_static.hpp), float and
+// double are formatted by constexpr_to_chars() instead, which produces the same output as
+// std::to_chars using exact (slow) big integer arithmetic.
+
+#if defined(__cpp_lib_bit_cast) && __cpp_lib_bit_cast >= 201806L && \
+    defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+#define LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT
+#endif
 
 namespace lazycat {
 
@@ -38,12 +51,291 @@ constexpr int sprintf_floating_point(char* buf, long double val) {
 }
 #endif
 
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+// An unsigned integer of up to 1280 bits, which is enough for the exact arithmetic on doubles in
+// constexpr_to_chars().
+struct constexpr_bignum {
+    std::uint32_t limbs[40]{};  // least significant first
+    size_t count = 0;           // number of limbs in use, without leading zero limbs
+
+    constexpr explicit constexpr_bignum(std::uint64_t value = 0) noexcept {
+        for (; value != 0; value >>= 32) limbs[count++] = static_cast<std::uint32_t>(value);
+    }
+    constexpr void shift_left(unsigned bits) noexcept {
+        if (count == 0) return;
+        const size_t words = bits / 32;
+        const unsigned rest = bits % 32;
+        for (size_t i = count + words + 1; i-- > words;) {
+            const size_t src = i - words;
+            const std::uint32_t hi = src < count ? limbs[src] << rest : 0;
+            const std::uint32_t lo =
+                rest != 0 && src != 0 && src <= count ? limbs[src - 1] >> (32 - rest) : 0;
+            limbs[i] = hi | lo;
+        }
+        for (size_t i = 0; i != words; ++i) limbs[i] = 0;
+        count += words + 1;
+        trim();
+    }
+    constexpr void multiply(std::uint32_t factor) noexcept {
+        std::uint64_t carry = 0;
+        for (size_t i = 0; i != count; ++i) {
+            carry += std::uint64_t{limbs[i]} * factor;
+            limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry != 0) limbs[count++] = static_cast<std::uint32_t>(carry);
+    }
+    constexpr void multiply_by_power_of_10(int exponent) noexcept {
+        for (; exponent >= 9; exponent -= 9) multiply(1000000000);
+        for (; exponent > 0; --exponent) multiply(10);
+    }
+    // Divides by divisor, returning the remainder.
+    constexpr std::uint32_t divide(std::uint32_t divisor) noexcept {
+        std::uint64_t remainder = 0;
+        for (size_t i = count; i-- > 0;) {
+            remainder = remainder << 32 | limbs[i];
+            limbs[i] = static_cast<std::uint32_t>(remainder / divisor);
+            remainder %= divisor;
+        }
+        trim();
+        return static_cast<std::uint32_t>(remainder);
+    }
+    constexpr void add(const constexpr_bignum& other) noexcept {
+        std::uint64_t carry = 0;
+        const size_t n = count > other.count ? count : other.count;
+        for (size_t i = 0; i != n; ++i) {
+            carry += std::uint64_t{limbs[i]} + other.limbs[i];
+            limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        count = n;
+        if (carry != 0) limbs[count++] = static_cast<std::uint32_t>(carry);
+    }
+    // Requires *this >= other.
+    constexpr void subtract(const constexpr_bignum& other) noexcept {
+        std::int64_t borrow = 0;
+        for (size_t i = 0; i != count; ++i) {
+            borrow += std::int64_t{limbs[i]} - other.limbs[i];
+            limbs[i] = static_cast<std::uint32_t>(borrow);
+            borrow = borrow < 0 ? -1 : 0;
+        }
+        trim();
+    }
+    constexpr void trim() noexcept {
+        while (count != 0 && limbs[count - 1] == 0) --count;
+    }
+    friend constexpr int compare(const constexpr_bignum& a, const constexpr_bignum& b) noexcept {
+        if (a.count != b.count) return a.count < b.count ? -1 : 1;
+        for (size_t i = a.count; i-- > 0;) {
+            if (a.limbs[i] != b.limbs[i]) return a.limbs[i] < b.limbs[i] ? -1 : 1;
+        }
+        return 0;
+    }
+};
+
+template <typename T>
+constexpr bool has_constexpr_to_chars =
+    std::numeric_limits<T>::is_iec559 &&
+    ((std::numeric_limits<T>::digits == 24 && sizeof(T) == sizeof(std::uint32_t)) ||
+     (std::numeric_limits<T>::digits == 53 && sizeof(T) == sizeof(std::uint64_t)));
+
+// Formats val exactly like std::to_chars(out, out + buffer_size, val): the shortest digits that
+// round trip (found with the algorithm of Burger and Dybvig, rounding ties to even like Ryu), in
+// fixed or scientific notation, whichever is shorter (fixed on ties).  Integers in fixed notation
+// are written exactly.  Returns the end of the output.
+template <typename T>
+constexpr char* constexpr_to_chars(char* out, T val) noexcept {
+    static_assert(has_constexpr_to_chars<T>);
+    using Bits = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t,
+                                    std::uint64_t>;
+    constexpr int mantissa_bits = std::numeric_limits<T>::digits - 1;
+    constexpr int exponent_mask = (1 << (sizeof(Bits) * 8 - 1 - mantissa_bits)) - 1;
+    constexpr int bias = exponent_mask / 2 + mantissa_bits;
+    const auto bits = std::bit_cast<Bits>(val);
+    const int biased_exponent = static_cast<int>(bits >> mantissa_bits) & exponent_mask;
+    std::uint64_t f = bits & ((Bits{1} << mantissa_bits) - 1);
+    if (bits >> (sizeof(Bits) * 8 - 1)) *out++ = '-';
+    if (biased_exponent == exponent_mask) {
+        const char* const special = f != 0 ? "nan" : "inf";
+        for (int i = 0; i != 3; ++i) *out++ = special[i];
+        return out;
+    }
+    if (biased_exponent == 0 && f == 0) {
+        *out++ = '0';
+        return out;
+    }
+    // val = f * 2^e
+    const int e = biased_exponent == 0 ? 1 - bias : biased_exponent - bias;
+    if (biased_exponent != 0) f |= std::uint64_t{1} << mantissa_bits;
+
+    // The digits are generated from r / s, with the rounding interval
+    // ((r - m_minus) / s, (r + m_plus) / s).  The interval is asymmetric for powers of 2.
+    const bool even = f % 2 == 0;
+    const unsigned unequal_gaps = f == std::uint64_t{1} << mantissa_bits && biased_exponent > 1;
+    constexpr_bignum r(f), s(1), m_plus(1), m_minus(1);
+    const unsigned e_pos = e > 0 ? static_cast<unsigned>(e) : 0;
+    const unsigned e_neg = e < 0 ? static_cast<unsigned>(-e) : 0;
+    r.shift_left(e_pos + 1 + unequal_gaps);
+    s.shift_left(e_neg + 1 + unequal_gaps);
+    m_minus.shift_left(e_pos);
+    m_plus.shift_left(e_pos + unequal_gaps);
+
+    // Scale so that the value is r / s * 10^k with r / s < 1.  The estimate of k never exceeds its
+    // final value (1233 / 4096 is slightly less than log10(2)).
+    const int x = e + static_cast<int>(std::bit_width(f)) - 1;
+    int k = x >= 0 ? x * 1233 / 4096 : -((-x * 1233 + 4095) / 4096);
+    if (k >= 0) {
+        s.multiply_by_power_of_10(k);
+    } else {
+        r.multiply_by_power_of_10(-k);
+        m_plus.multiply_by_power_of_10(-k);
+        m_minus.multiply_by_power_of_10(-k);
+    }
+    const auto high_reaches = [&](const constexpr_bignum& rest) {
+        constexpr_bignum high = rest;
+        high.add(m_plus);
+        const int c = compare(high, s);
+        return even ? c >= 0 : c > 0;
+    };
+    while (high_reaches(r)) {
+        s.multiply(10);
+        ++k;
+    }
+
+    char digits[std::numeric_limits<T>::max_digits10 + 1]{};
+    int n = 0;
+    for (;;) {
+        r.multiply(10);
+        m_plus.multiply(10);
+        m_minus.multiply(10);
+        char d = 0;
+        while (compare(r, s) >= 0) {
+            r.subtract(s);
+            ++d;
+        }
+        const int low_cmp = compare(r, m_minus);
+        const bool low = even ? low_cmp <= 0 : low_cmp < 0;
+        const bool high = high_reaches(r);
+        if (!low && !high) {
+            digits[n++] = d;
+            continue;
+        }
+        if (low && high) {
+            constexpr_bignum twice = r;
+            twice.shift_left(1);
+            const int c = compare(twice, s);
+            if (c > 0 || (c == 0 && d % 2 != 0)) ++d;
+        } else if (high) {
+            ++d;
+        }
+        digits[n++] = d;
+        break;
+    }
+
+    // val is 0.digits * 10^k, or digits[0].digits[1..] * 10^exponent
+    const int exponent = k - 1;
+    const int abs_exponent = exponent < 0 ? -exponent : exponent;
+    const int scientific_size = n + (n > 1) + 2 + (abs_exponent >= 100 ? 3 : 2);
+    const int fixed_size =
+        exponent < 0 ? n + 1 - exponent : n > exponent + 1 ? n + 1 : exponent + 1;
+    if (fixed_size <= scientific_size) {
+        if (exponent < 0) {
+            *out++ = '0';
+            *out++ = '.';
+            for (int i = 0; i != -exponent - 1; ++i) *out++ = '0';
+            for (int i = 0; i != n; ++i) *out++ = static_cast<char>('0' + digits[i]);
+        } else if (n > exponent + 1) {
+            for (int i = 0; i != n; ++i) {
+                if (i == exponent + 1) *out++ = '.';
+                *out++ = static_cast<char>('0' + digits[i]);
+            }
+        } else {
+            // Write the exact integer, like std::to_chars (not the shortest digits padded with 0s)
+            constexpr_bignum integer(e >= 0 ? f : f >> -e);
+            if (e > 0) integer.shift_left(static_cast<unsigned>(e));
+            out += exponent + 1;
+            for (int i = 0; i != exponent + 1; ++i) {
+                out[-1 - i] = static_cast<char>('0' + integer.divide(10));
+            }
+        }
+        return out;
+    }
+    *out++ = static_cast<char>('0' + digits[0]);
+    if (n > 1) {
+        *out++ = '.';
+        for (int i = 1; i != n; ++i) *out++ = static_cast<char>('0' + digits[i]);
+    }
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    if (abs_exponent >= 100) *out++ = static_cast<char>('0' + abs_exponent / 100);
+    *out++ = static_cast<char>('0' + abs_exponent / 10 % 10);
+    *out++ = static_cast<char>('0' + abs_exponent % 10);
+    return out;
+}
+
+// Formats val exactly like std::to_chars(out, out + size, val, std::chars_format::fixed, precision)
+// for 0 <= precision <= 15: the exact value rounded to `precision` digits after the decimal point,
+// with ties rounded to even.  The buffer must be large enough.  Returns the end of the output.
+constexpr char* constexpr_to_chars_fixed(char* out, double val, int precision) noexcept {
+    constexpr int mantissa_bits = std::numeric_limits<double>::digits - 1;
+    constexpr int exponent_mask = 0x7FF;
+    constexpr int bias = exponent_mask / 2 + mantissa_bits;
+    const auto bits = std::bit_cast<std::uint64_t>(val);
+    const int biased_exponent = static_cast<int>(bits >> mantissa_bits) & exponent_mask;
+    std::uint64_t f = bits & ((std::uint64_t{1} << mantissa_bits) - 1);
+    if (bits >> 63) *out++ = '-';
+    if (biased_exponent == exponent_mask) {
+        const char* const special = f != 0 ? "nan" : "inf";
+        for (int i = 0; i != 3; ++i) *out++ = special[i];
+        return out;
+    }
+    // val = f * 2^e, and the output is the integer round(f * 2^e * 10^precision) with a decimal
+    // point inserted
+    const int e = biased_exponent == 0 ? 1 - bias : biased_exponent - bias;
+    if (biased_exponent != 0) f |= std::uint64_t{1} << mantissa_bits;
+    constexpr_bignum scaled(f);
+    scaled.multiply_by_power_of_10(precision);
+    if (e >= 0) {
+        scaled.shift_left(static_cast<unsigned>(e));
+    } else {
+        const unsigned shift = static_cast<unsigned>(-e);
+        constexpr_bignum quotient = scaled;
+        unsigned left = shift;
+        for (; left >= 31; left -= 31) quotient.divide(std::uint32_t{1} << 31);
+        if (left != 0) quotient.divide(std::uint32_t{1} << left);
+        // Round half to even, comparing twice the remainder with the divisor
+        constexpr_bignum truncated = quotient;
+        truncated.shift_left(shift);
+        constexpr_bignum twice_remainder = scaled;
+        twice_remainder.subtract(truncated);
+        twice_remainder.shift_left(1);
+        constexpr_bignum divisor(1);
+        divisor.shift_left(shift);
+        const int c = compare(twice_remainder, divisor);
+        if (c > 0 || (c == 0 && quotient.count != 0 && quotient.limbs[0] % 2 != 0)) {
+            quotient.add(constexpr_bignum(1));
+        }
+        scaled = quotient;
+    }
+    char digits[340]{};  // least significant first; at most 309 integer digits and the precision
+    int n = 0;
+    while (scaled.count != 0) digits[n++] = static_cast<char>('0' + scaled.divide(10));
+    while (n < precision + 1) digits[n++] = '0';
+    for (int i = n; i-- > precision;) *out++ = digits[i];
+    if (precision > 0) {
+        *out++ = '.';
+        for (int i = precision; i-- > 0;) *out++ = digits[i];
+    }
+    return out;
+}
+#endif
+
 }  // namespace detail
 
 template <typename T>
 struct floating_point_writer : public base_writer {
     T content;
-    constexpr static size_t buffer_size = round_up_to_multiple(
+    constexpr static size_t buffer_size = detail::round_up_to_multiple(
         static_cast<size_t>(
             4 + std::numeric_limits<T>::max_digits10 +
             std::max(2, detail::log10_ceil(std::numeric_limits<T>::max_exponent10))),
@@ -51,6 +343,14 @@ struct floating_point_writer : public base_writer {
     alignas(T) mutable char cached_buffer[buffer_size];
     mutable size_t cached_size;
     constexpr size_t size() const noexcept {
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+        if constexpr (detail::has_constexpr_to_chars<T>) {
+            if (std::is_constant_evaluated()) {
+                return cached_size = detail::constexpr_to_chars(cached_buffer, content) -
+                                     cached_buffer;
+            }
+        }
+#endif
 #if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
         char* const end = std::to_chars(cached_buffer, cached_buffer + buffer_size, content).ptr;
         return cached_size = end - cached_buffer;
@@ -59,21 +359,22 @@ struct floating_point_writer : public base_writer {
         return cached_size = ct;
 #endif
     }
-#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
-    constexpr char* write(char* out) const noexcept {
-        if (std::is_constant_evaluated()) {
-            return std::copy(cached_buffer, cached_buffer + cached_size, out);
-        } else {
-            std::memcpy(out, cached_buffer, cached_size);
-            return out + cached_size;
+    // The formatted number is ASCII, so it is widened straight into wide outputs.
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+        if constexpr (detail::has_constexpr_to_chars<T>) {
+            // Some compilers (e.g. GCC 12) do not allow reading mutable members in constant
+            // evaluation, so the number is formatted again
+            if (std::is_constant_evaluated()) {
+                char buffer[buffer_size]{};
+                const char* const end = detail::constexpr_to_chars(buffer, content);
+                return detail::copy_chars(buffer, static_cast<size_t>(end - buffer), out);
+            }
         }
-    }
-#else
-    char* write(char* out) const noexcept {
-        std::memcpy(out, cached_buffer, cached_size);
-        return out + cached_size;
-    }
 #endif
+        return detail::copy_chars(cached_buffer, cached_size, out);
+    }
 };
 
 template <typename Catter,
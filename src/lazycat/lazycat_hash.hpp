@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/util.hpp>
+#include <type_traits>
+
+// This file contains hashed_build(), which materializes a catter like build() and feeds the output
+// to an incremental hasher as it is written, instead of in a second pass over the string:
+//
+//   lazycat::crc32c crc;
+//   std::string record = lazycat::hashed_build(lazycat::cat(id, '\t', name, '\n'), crc);
+//   store(record, crc.value());
+//
+// A hasher is any object with update(const void* data, size_t size), so e.g. a wrapper around
+// XXH3_64bits_update works too.  The output is fed in chunks of at least hash_chunk_size bytes,
+// as soon as the writers that produced a chunk have finished (so it is still in L1 cache), and the
+// rest at the end.  crc32c computes CRC-32C (Castagnoli) with the SSE4.2 crc32 instruction where
+// available, and with lookup tables (slicing by 8) otherwise.
+
+namespace lazycat {
+
+// The minimum number of bytes passed to the hasher at once by hashed_build(), except at the end.
+inline constexpr size_t hash_chunk_size = 256;
+
+namespace detail {
+
+// crc32c_tables[k][b] is the CRC of byte b followed by k zero bytes (without pre- and
+// post-conditioning), for processing 8 bytes per step.
+inline constexpr auto crc32c_tables = [] {
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t b = 0; b != 256; ++b) {
+        std::uint32_t crc = b;
+        for (int i = 0; i != 8; ++i) crc = (crc >> 1) ^ (crc & 1 ? 0x82F63B78 : 0);
+        tables[0][b] = crc;
+    }
+    for (size_t k = 1; k != 8; ++k) {
+        for (size_t b = 0; b != 256; ++b) {
+            tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+        }
+    }
+    return tables;
+}();
+
+template <typename Hasher, typename CharT>
+struct hashing_observer {
+    Hasher& hasher;
+    const CharT* unhashed;  // the start of the output that has not been fed to the hasher yet
+    void operator()(const CharT*, const CharT* last) {
+        if (static_cast<size_t>(last - unhashed) * sizeof(CharT) >= hash_chunk_size) flush(last);
+    }
+    void flush(const CharT* last) {
+        if (last == unhashed) return;
+        hasher.update(unhashed, static_cast<size_t>(last - unhashed) * sizeof(CharT));
+        unhashed = last;
+    }
+};
+
+}  // namespace detail
+
+// An incremental CRC-32C (the checksum of iSCSI, ext4 and many storage formats).
+class crc32c {
+   public:
+    void update(const void* data, size_t size) noexcept {
+        const auto* p = static_cast<const unsigned char*>(data);
+        std::uint32_t crc = state_;
+#if defined(LAZYCAT_HAS_SSE42)
+#if defined(__x86_64__) || defined(_M_X64)
+        std::uint64_t crc64 = crc;
+        for (; size >= 8; size -= 8, p += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<std::uint32_t>(crc64);
+#endif
+        for (; size >= 4; size -= 4, p += 4) {
+            std::uint32_t word;
+            std::memcpy(&word, p, 4);
+            crc = _mm_crc32_u32(crc, word);
+        }
+        for (; size != 0; --size) crc = _mm_crc32_u8(crc, *p++);
+#else
+        const auto& t = detail::crc32c_tables;
+        for (; size >= 8; size -= 8, p += 8) {
+            const std::uint32_t lo = crc ^ (std::uint32_t{p[0]} | std::uint32_t{p[1]} << 8 |
+                                            std::uint32_t{p[2]} << 16 | std::uint32_t{p[3]} << 24);
+            crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^
+                  t[4][lo >> 24] ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        }
+        for (; size != 0; --size) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+#endif
+        state_ = crc;
+    }
+    std::uint32_t value() const noexcept { return ~state_; }
+
+   private:
+    std::uint32_t state_ = 0xFFFFFFFF;
+};
+
+// Materializes the catter like build(), feeding the output to hasher.update() while it is written.
+template <typename Catter,
+          typename Hasher,
+          typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+typename Catter::string_type hashed_build(const Catter& c, Hasher& hasher) {
+    using CharT = typename Catter::char_type;
+    const size_t sz = c.size();
+    typename Catter::string_type ret = detail::construct_default_init<CharT>(sz);
+    detail::hashing_observer<Hasher, CharT> observer{hasher, ret.data()};
+    if (sz * sizeof(CharT) < hash_chunk_size) {
+        observer.flush(c.write(ret.data()));  // a single chunk anyway
+    } else {
+        observer.flush(c.write_observed(ret.data(), observer));
+    }
+    return ret;
+}
+
+}  // namespace lazycat
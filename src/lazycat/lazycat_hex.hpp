@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/util.hpp>
+#include <span>
+
+// This file contains writers for binary data in lowercase hexadecimal:
+//   hex_bytes(span)  two hex digits per byte, e.g. for SHA-256 digests
+//   uuid(bytes)      "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" (fixed size 36)
+// With SSE2, 16 bytes are converted to 32 hex digits at a time.
+
+namespace lazycat {
+
+namespace detail {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+// Writes 2 * count hex digits.
+template <typename CharT>
+constexpr CharT* hex_encode(const std::uint8_t* in, size_t count, CharT* out) noexcept {
+#if defined(LAZYCAT_HAS_SSE2) && defined(__cpp_lib_is_constant_evaluated) && \
+    __cpp_lib_is_constant_evaluated >= 201811
+    if constexpr (sizeof(CharT) == 1) {
+        if (!std::is_constant_evaluated()) {
+            const __m128i low_nibble = _mm_set1_epi8(0x0F);
+            const __m128i nine = _mm_set1_epi8(9);
+            const __m128i ascii_zero = _mm_set1_epi8('0');
+            const __m128i letter_offset = _mm_set1_epi8('a' - '0' - 10);
+            const auto to_ascii = [&](__m128i nibbles) {
+                const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter_offset);
+                return _mm_add_epi8(_mm_add_epi8(nibbles, ascii_zero), letters);
+            };
+            for (; count >= 16; count -= 16, in += 16, out += 32) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+                const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble);
+                const __m128i lo = _mm_and_si128(v, low_nibble);
+                // Interleave so that the high nibble of each byte comes first
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                                 to_ascii(_mm_unpacklo_epi8(hi, lo)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16),
+                                 to_ascii(_mm_unpackhi_epi8(hi, lo)));
+            }
+        }
+    }
+#endif
+    for (size_t i = 0; i != count; ++i) {
+        *out++ = static_cast<CharT>(hex_digits[in[i] >> 4]);
+        *out++ = static_cast<CharT>(hex_digits[in[i] & 0x0F]);
+    }
+    return out;
+}
+
+}  // namespace detail
+
+struct hex_bytes_writer : public base_writer {
+    std::span<const std::uint8_t> content;
+    constexpr size_t size() const noexcept { return content.size() * 2; }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        return detail::hex_encode(content.data(), content.size(), out);
+    }
+};
+
+struct uuid_writer : public base_writer {
+    std::array<std::uint8_t, 16> content;
+    constexpr static size_t size() noexcept { return 36; }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        // Encode all 32 digits at once, then insert the dashes
+        CharT digits[32];
+        detail::hex_encode(content.data(), 16, digits);
+        out = detail::copy_chars(digits, 8, out);
+        *out++ = static_cast<CharT>('-');
+        out = detail::copy_chars(digits + 8, 4, out);
+        *out++ = static_cast<CharT>('-');
+        out = detail::copy_chars(digits + 12, 4, out);
+        *out++ = static_cast<CharT>('-');
+        out = detail::copy_chars(digits + 16, 4, out);
+        *out++ = static_cast<CharT>('-');
+        return detail::copy_chars(digits + 20, 12, out);
+    }
+};
+
+[[nodiscard]] constexpr hex_bytes_writer hex_bytes(std::span<const std::uint8_t> content) noexcept {
+    return hex_bytes_writer{{}, content};
+}
+
+[[nodiscard]] inline hex_bytes_writer hex_bytes(std::span<const std::byte> content) noexcept {
+    return hex_bytes_writer{
+        {}, {reinterpret_cast<const std::uint8_t*>(content.data()), content.size()}};
+}
+
+[[nodiscard]] constexpr uuid_writer uuid(std::span<const std::uint8_t, 16> bytes) noexcept {
+    uuid_writer ret{{}, {}};
+    for (size_t i = 0; i != 16; ++i) ret.content[i] = bytes[i];
+    return ret;
+}
+
+}  // namespace lazycat
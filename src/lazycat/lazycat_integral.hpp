@@ -1,16 +1,33 @@
 #pragma once
 
 #include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <lazycat/lazycat_core.hpp>
 #include <lazycat/util.hpp>
 #include <limits>
+#include <span>
+#include <system_error>
 #include <type_traits>
 
-// This file contains the writer for integral types
+// This file contains the writer for integral types, and parse_integral(), the matching parser
 
 namespace lazycat {
 
 namespace detail {
+template <typename T>
+static constexpr unsigned num_digits_base_2(T t) noexcept {
+    static_assert(std::is_unsigned_v<T>);
+    unsigned ct = 0;
+    while (t > 0) {
+        ++ct;
+        t >>= 1;
+    }
+    return ct;
+}
+
 // Computes the number of base-2 digits in val.  Requires T to be unsigned.  Assumes that val != 0.
 // For example:
 //   bit_width_nonzero(1) == 1
@@ -19,72 +36,24 @@ namespace detail {
 //   bit_width_nonzero(4) == 3
 //   bit_width_nonzero(7) == 3
 //   bit_width_nonzero(8) == 4
+// std::bit_width is constexpr and compiles to a single LZCNT (or BSR) on x86 and CLZ on ARM, so no
+// intrinsics are needed.  Wider types (e.g. unsigned __int128) are scanned in 64-bit chunks from
+// the top.
 template <typename T>
-inline LAZYCAT_FORCEINLINE unsigned bit_width_nonzero(const T& val) noexcept {
+constexpr LAZYCAT_FORCEINLINE unsigned bit_width_nonzero(const T& val) noexcept {
     static_assert(std::is_unsigned_v<T>);
     LAZYCAT_ASSUME(val != 0);
-#if !defined(_MSC_VER)
-#if defined(__BMI__)
-    if constexpr (std::numeric_limits<T>::digits <= 32) {
-        return std::numeric_limits<T>::digits - _lzcnt_u32(val);
-    } else if constexpr (std::numeric_limits<T>::digits <= 64) {
-        return std::numeric_limits<T>::digits - static_cast<unsigned>(_lzcnt_u64(val));
+    if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<std::uint64_t>::digits) {
+        return static_cast<unsigned>(std::bit_width(val));
     } else {
-        constexpr unsigned num_steps = (std::numeric_limits<T>::digits - 1) / 64 + 1;
-        for (unsigned i = num_steps - 1; i != std::numeric_limits<unsigned>::min(); --i) {
-            const unsigned __int64 chunk = static_cast<unsigned __int64>(val >> (i * 64));
-            if (chunk != 0)
-                return i * 64 +
-                       (std::numeric_limits<T>::digits - static_cast<unsigned>(_lzcnt_u64(chunk)));
+        constexpr unsigned chunk_digits = std::numeric_limits<std::uint64_t>::digits;
+        constexpr unsigned num_steps = (std::numeric_limits<T>::digits - 1) / chunk_digits + 1;
+        for (unsigned i = num_steps - 1; i != std::numeric_limits<unsigned>::max(); --i) {
+            const auto chunk = static_cast<std::uint64_t>(val >> (i * chunk_digits));
+            if (chunk != 0) return i * chunk_digits + static_cast<unsigned>(std::bit_width(chunk));
         }
         return 0;
     }
-#else
-    if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<unsigned>::digits) {
-        return std::numeric_limits<unsigned>::digits - __builtin_clz(val);
-    } else if constexpr (std::numeric_limits<T>::digits <=
-                         std::numeric_limits<unsigned long>::digits) {
-        return std::numeric_limits<unsigned long>::digits - __builtin_clzl(val);
-    } else if constexpr (std::numeric_limits<T>::digits <=
-                         std::numeric_limits<unsigned long long>::digits) {
-        return std::numeric_limits<unsigned long long>::digits - __builtin_clzll(val);
-    } else {
-        constexpr unsigned num_steps =
-            (std::numeric_limits<T>::digits - 1) / std::numeric_limits<unsigned long long>::digits +
-            1;
-        for (unsigned i = num_steps - 1; i != std::numeric_limits<unsigned>::min(); --i) {
-            const unsigned long long chunk = static_cast<unsigned long long>(
-                val >> (i * std::numeric_limits<unsigned long long>::digits));
-            if (chunk != 0)
-                return i * std::numeric_limits<unsigned long long>::digits +
-                       (std::numeric_limits<unsigned long long>::digits - __builtin_clzll(chunk));
-        }
-        return 0;
-    }
-#endif
-#else
-    if constexpr (std::numeric_limits<T>::digits <= std::numeric_limits<unsigned>::digits) {
-        return std::numeric_limits<unsigned>::digits - __lzcnt(val);
-    } else if constexpr (std::numeric_limits<T>::digits <=
-                         std::numeric_limits<unsigned __int64>::digits) {
-        return std::numeric_limits<unsigned __int64>::digits -
-               static_cast<unsigned>(__lzcnt64(val));
-    } else {
-        constexpr unsigned num_steps =
-            (std::numeric_limits<T>::digits - 1) / std::numeric_limits<unsigned __int64>::digits +
-            1;
-        for (unsigned i = num_steps - 1; i != numeric_limits<unsigned>::min(); --i) {
-            const unsigned __int64 chunk = static_cast<unsigned __int64>(
-                val >> (i * std::numeric_limits<unsigned __int64>::digits));
-            if (chunk != 0)
-                return i * std::numeric_limits<unsigned __int64>::digits +
-                       (std::numeric_limits<unsigned __int64>::digits -
-                        static_cast<unsigned>(__lzcnt64(chunk)));
-        }
-        return 0;
-    }
-    return std::numeric_limits<T>::digits - __lzcnt(val);
-#endif
 }
 
 // Stores the powers of 10 minus 1
@@ -109,17 +78,6 @@ static constexpr std::array<T, std::numeric_limits<T>::digits10 + 2> powers_of_1
     return powers;
 }();
 
-template <typename T>
-static constexpr unsigned num_digits_base_2(T t) noexcept {
-    static_assert(std::is_unsigned_v<T>);
-    unsigned ct = 0;
-    while (t > 0) {
-        ++ct;
-        t >>= 1;
-    }
-    return ct;
-}
-
 // Calculates and stores the conversion constants: approx_log10 = (approx_log2 * multiplier) >>
 // rshift;
 template <size_t MaxDigits, typename T>
@@ -152,7 +110,7 @@ struct log2_to_log10_converter_values {
 };
 
 template <size_t MaxDigits, typename T>
-inline LAZYCAT_FORCEINLINE size_t calculate_integral_size_unsigned(const T& val) noexcept {
+constexpr LAZYCAT_FORCEINLINE size_t calculate_integral_size_unsigned(const T& val) noexcept {
     static_assert(std::is_unsigned_v<T>);
 
     // This is necessary for two reasons:
@@ -178,7 +136,7 @@ inline LAZYCAT_FORCEINLINE size_t calculate_integral_size_unsigned(const T& val)
 // Wrapper in case integer is negative
 // MaxDigits is the maximum number of digits it could have, excluding the '-' sign
 template <size_t MaxDigits, typename T>
-inline LAZYCAT_FORCEINLINE size_t calculate_integral_size(const T& val) noexcept {
+constexpr LAZYCAT_FORCEINLINE size_t calculate_integral_size(const T& val) noexcept {
     if constexpr (std::is_signed_v<T>) {  // signed
         if (val < static_cast<T>(0)) {    // negative
             return calculate_integral_size_unsigned<MaxDigits>(static_cast<std::make_unsigned_t<T>>(
@@ -193,22 +151,40 @@ inline LAZYCAT_FORCEINLINE size_t calculate_integral_size(const T& val) noexcept
     }
 }
 
-template <typename T>
-inline LAZYCAT_FORCEINLINE void write_integral_chars_unsigned(char* out_end, T val) noexcept {
+// Stores the two-digit decimal representations of 0 to 99 ("00", "01", ..., "99")
+static constexpr std::array<char, 200> digit_pairs = []() {
+    std::array<char, 200> pairs{};
+    for (size_t i = 0; i != 100; ++i) {
+        pairs[i * 2] = static_cast<char>('0' + i / 10);
+        pairs[i * 2 + 1] = static_cast<char>('0' + i % 10);
+    }
+    return pairs;
+}();
+
+// Writes val (which must be less than 100) as exactly two digits.
+template <typename CharT>
+constexpr CharT* write_2_digits(CharT* out, unsigned val) noexcept {
+    *out++ = static_cast<CharT>(digit_pairs[val * 2]);
+    *out++ = static_cast<CharT>(digit_pairs[val * 2 + 1]);
+    return out;
+}
+
+template <typename CharT, typename T>
+constexpr LAZYCAT_FORCEINLINE void write_integral_chars_unsigned(CharT* out_end, T val) noexcept {
     static_assert(std::is_unsigned_v<T> && std::is_integral_v<T>,
                   "T should be an unsigned integer");
     // Note: do-while loop ensures that zero is written as "0".
     do {
-        *--out_end = '0' + static_cast<char>(val % static_cast<T>(10));
+        *--out_end = static_cast<CharT>('0' + static_cast<char>(val % static_cast<T>(10)));
         val /= static_cast<T>(10);
     } while (val > static_cast<T>(0));
 }
 
 // Wrapper in case integer is negative
-template <typename T>
-inline LAZYCAT_FORCEINLINE char* write_integral_chars(char* out,
-                                                      const T& val,
-                                                      size_t cached_size) noexcept {
+template <typename CharT, typename T>
+constexpr LAZYCAT_FORCEINLINE CharT* write_integral_chars(CharT* out,
+                                                          const T& val,
+                                                          size_t cached_size) noexcept {
     // We write digits from back to front
     if constexpr (std::is_signed_v<T>) {  // signed
         std::make_unsigned_t<T> tmp;
@@ -237,13 +213,22 @@ template <typename T>
 struct integral_writer : public base_writer {
     T content;
     mutable size_t cached_size;  // cached value of size
-    constexpr size_t size() const noexcept {
-        return cached_size =
-                   detail::calculate_integral_size<std::numeric_limits<T>::digits10 + 1>(content);
-    }
-    constexpr char* write(char* out) const noexcept {
+    constexpr size_t size() const noexcept { return cached_size = uncached_size(); }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+        // Some compilers (e.g. GCC 12) do not allow reading mutable members in constant evaluation
+        if (std::is_constant_evaluated()) {
+            return detail::write_integral_chars(out, content, uncached_size());
+        }
+#endif
         return detail::write_integral_chars(out, content, cached_size);
     }
+    constexpr size_t uncached_size() const noexcept {
+        // The bound for the unsigned type also covers the magnitude of the minimum signed value
+        return detail::calculate_integral_size<
+            std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1>(content);
+    }
 };
 
 // Allow only `[un]signed (char|short|int|long|long long|<extension integrals>)`, to avoid conflict
@@ -258,4 +243,408 @@ constexpr auto operator<<(Catter c, T curr) noexcept {
     return c << integral_writer<T>{{}, std::move(curr), 0};
 }
 
+namespace detail {
+
+// The 8 digits (with leading zeros) of val < 10^8 as chars, the first in the lowest byte: splits
+// into groups of 4, then 2, then 1 digits in the lanes of a word, dividing by multiplying.  The
+// word is only in memory order on little-endian targets.
+inline LAZYCAT_FORCEINLINE std::uint64_t format_8_digits(std::uint32_t val) noexcept {
+    const std::uint64_t quads = val / 10000 | std::uint64_t{val % 10000} << 32;
+    const std::uint64_t hundreds = ((quads * 10486) >> 20) & 0x0000007F0000007F;  // / 100
+    const std::uint64_t pairs = ((quads - 100 * hundreds) << 16) + hundreds;
+    const std::uint64_t tens = ((pairs * 103) >> 10) & 0x000F000F000F000F;  // / 10
+    return tens + ((pairs - 10 * tens) << 8) + 0x3030303030303030;
+}
+
+// Copies 1 to MaxCount (at most 32) chars with at most two (overlapping) loads and stores, so that
+// the branches depend on the size class rather than on every char.
+template <size_t MaxCount>
+inline LAZYCAT_FORCEINLINE char* copy_short(const char* in, size_t count, char* out) noexcept {
+    static_assert(MaxCount <= 32);
+    const auto copy_pair = [&](auto word) {
+        decltype(word) tail;
+        std::memcpy(&word, in, sizeof(word));
+        std::memcpy(&tail, in + count - sizeof(word), sizeof(word));
+        std::memcpy(out, &word, sizeof(word));
+        std::memcpy(out + count - sizeof(word), &tail, sizeof(word));
+    };
+    if (MaxCount >= 8 && count >= 8) {
+        if (MaxCount >= 16 && count >= 16) {
+            copy_pair(std::array<std::uint64_t, 2>{});
+        } else {
+            copy_pair(std::uint64_t{});
+        }
+    } else if (count >= 4) {
+        copy_pair(std::uint32_t{});
+    } else {
+        out[0] = in[0];
+        out[count / 2] = in[count / 2];
+        out[count - 1] = in[count - 1];
+    }
+    return out + count;
+}
+
+}  // namespace detail
+
+// Writes the same chars as integral_writer, in a way that suits values whose number of digits
+// is unpredictable (e.g. random ids or hashes): the sign is handled without branches, a fixed
+// block of 10 (up to 32 bits) or 20 digits is formatted into a scratch buffer, and its last
+// cached_size digits are copied.  Values of predictable length are faster with integral_writer.
+template <typename T>
+struct branchless_integral_writer : public base_writer {
+    static_assert(sizeof(T) <= sizeof(std::uint64_t), "Only integers of up to 64 bits");
+    using wide_type = std::conditional_t<sizeof(T) <= 4, std::uint32_t, std::uint64_t>;
+    T content;
+    mutable size_t cached_size;  // cached value of size
+    constexpr size_t size() const noexcept {
+        const wide_type mask = negative_mask();
+        return cached_size = detail::calculate_integral_size_unsigned<
+                                 std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1>(
+                                 magnitude(mask)) +
+                             (mask & 1);
+    }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+        if (std::is_constant_evaluated()) {
+            return integral_writer<T>{{}, content, 0}.write(out);
+        }
+#endif
+        if constexpr (std::endian::native != std::endian::little) {
+            // The words of format_8_digits would be stored with their digits reversed
+            return detail::write_integral_chars(out, content, cached_size);
+        }
+        const wide_type mask = negative_mask();
+        const wide_type val = magnitude(mask);
+        constexpr size_t width = sizeof(wide_type) == 4 ? 10 : 20;
+        char digits[width];
+        if constexpr (sizeof(wide_type) == 4) {
+            // At most 42 above the last 8 digits
+            detail::write_2_digits(digits, static_cast<unsigned>(val / 100000000));
+            const std::uint64_t low = detail::format_8_digits(val % 100000000);
+            std::memcpy(digits + 2, &low, 8);
+        } else {
+            // At most 1844 above the last 16 digits
+            const auto high = static_cast<unsigned>(val / 10000000000000000);
+            detail::write_2_digits(detail::write_2_digits(digits, high / 100), high % 100);
+            const std::uint64_t rest = val % 10000000000000000;
+            const std::uint64_t middle =
+                detail::format_8_digits(static_cast<std::uint32_t>(rest / 100000000));
+            const std::uint64_t low =
+                detail::format_8_digits(static_cast<std::uint32_t>(rest % 100000000));
+            std::memcpy(digits + 4, &middle, 8);
+            std::memcpy(digits + 12, &low, 8);
+        }
+        // The sign is overwritten by the first digit if the value is not negative
+        *out = static_cast<CharT>('-');
+        const size_t sign = mask & 1;
+        const size_t count = cached_size - sign;
+        if constexpr (sizeof(CharT) == 1) {
+            return reinterpret_cast<CharT*>(detail::copy_short<width>(
+                digits + width - count, count, reinterpret_cast<char*>(out + sign)));
+        } else {
+            return detail::copy_chars(digits + width - count, count, out + sign);
+        }
+    }
+
+   private:
+    // All ones if the value is negative, otherwise zero
+    constexpr wide_type negative_mask() const noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            return wide_type{0} - static_cast<wide_type>(content < 0);
+        } else {
+            return 0;
+        }
+    }
+    constexpr wide_type magnitude(wide_type mask) const noexcept {
+        return (static_cast<wide_type>(content) ^ mask) - mask;
+    }
+};
+
+// Writes x like integral_writer, with fewer branches that depend on its number of digits (see
+// branchless_integral_writer).  Integers wider than 64 bits (e.g. __int128) are not supported.
+template <typename T,
+          typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                      sizeof(T) <= sizeof(std::uint64_t)>,
+          typename = std::enable_if_t<std::is_same_v<T, std::make_signed_t<T>> ||
+                                      std::is_same_v<T, std::make_unsigned_t<T>>>>
+[[nodiscard]] constexpr branchless_integral_writer<T> branchless(T x) noexcept {
+    return {{}, x, 0};
+}
+
+namespace detail {
+
+#if defined(LAZYCAT_HAS_AVX2)
+// The sizes (as written by cat()) of 8 32-bit integers at p, in 32-bit lanes: one digit, plus one
+// for each power of 10 that the magnitude reaches, plus the '-' sign.
+template <typename T>
+inline LAZYCAT_FORCEINLINE __m256i integral_sizes_x8(const T* p) noexcept {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i magnitude = x, sign = _mm256_setzero_si256();
+    if constexpr (std::is_signed_v<T>) {
+        sign = _mm256_srai_epi32(x, 31);  // -1 if negative
+        magnitude = _mm256_abs_epi32(x);  // the minimum becomes 2^31 as an unsigned value
+    }
+    // Unsigned comparisons, as signed comparisons of the values with the top bit flipped
+    const __m256i biased = _mm256_xor_si256(magnitude, _mm256_set1_epi32(INT32_MIN));
+    __m256i size = _mm256_sub_epi32(_mm256_set1_epi32(1), sign);
+    for (size_t i = 1; i != std::numeric_limits<std::uint32_t>::digits10 + 1; ++i) {
+        const auto bound = static_cast<std::int32_t>(powers_of_10_minus_1<std::uint32_t>[i] ^
+                                                     std::uint32_t{0x80000000});
+        size = _mm256_sub_epi32(size, _mm256_cmpgt_epi32(biased, _mm256_set1_epi32(bound)));
+    }
+    return size;
+}
+
+// The sizes of 4 64-bit integers at p, in 64-bit lanes, computed like
+// calculate_integral_size_unsigned().  The bit width comes from the exponent of a double: the
+// 32-bit half that holds the top bit is placed in the mantissa of 2^52, which is exact.
+template <typename T>
+inline LAZYCAT_FORCEINLINE __m256i integral_sizes_x4(const T* p) noexcept {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i magnitude = x, sign = _mm256_setzero_si256();
+    if constexpr (std::is_signed_v<T>) {
+        sign = _mm256_cmpgt_epi64(sign, x);  // -1 if negative
+        magnitude = _mm256_sub_epi64(_mm256_xor_si256(x, sign), sign);
+    }
+    const __m256i tmp = _mm256_or_si256(magnitude, _mm256_set1_epi64x(1));
+    const __m256i high = _mm256_srli_epi64(tmp, 32);
+    const __m256i has_high = _mm256_cmpgt_epi64(high, _mm256_setzero_si256());
+    const __m256i half =
+        _mm256_blendv_epi8(_mm256_and_si256(tmp, _mm256_set1_epi64x(0xFFFFFFFF)), high, has_high);
+    const __m256i mantissa = _mm256_or_si256(half, _mm256_set1_epi64x(0x4330000000000000));
+    const __m256d as_double = _mm256_sub_pd(_mm256_castsi256_pd(mantissa),
+                                            _mm256_set1_pd(4503599627370496.0));  // minus 2^52
+    const __m256i bit_width =
+        _mm256_add_epi64(_mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(as_double), 52),
+                                          _mm256_set1_epi64x(1022)),
+                         _mm256_and_si256(has_high, _mm256_set1_epi64x(32)));
+    using converter =
+        log2_to_log10_converter_values<std::numeric_limits<std::uint64_t>::digits10 + 1,
+                                       std::uint64_t>;
+    const __m256i approx_log10 = _mm256_srli_epi64(
+        _mm256_mul_epu32(bit_width, _mm256_set1_epi64x(converter::multiplier)), converter::rshift);
+    const __m256i bound = _mm256_i64gather_epi64(
+        reinterpret_cast<const long long*>(powers_of_10_minus_1<std::uint64_t>.data()),
+        approx_log10, 8);
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i above =
+        _mm256_cmpgt_epi64(_mm256_xor_si256(tmp, bias), _mm256_xor_si256(bound, bias));
+    return _mm256_sub_epi64(_mm256_sub_epi64(approx_log10, above), sign);
+}
+
+// Stores the low byte of each 32-bit lane.
+inline LAZYCAT_FORCEINLINE void store_sizes_x8(std::uint8_t* out, __m256i sizes) noexcept {
+    const __m256i bytes = _mm256_shuffle_epi8(
+        sizes, _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+                                -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1));
+    const __m128i packed =
+        _mm_or_si128(_mm256_castsi256_si128(bytes), _mm256_extracti128_si256(bytes, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+}
+
+// Stores the low byte of each 64-bit lane.
+inline LAZYCAT_FORCEINLINE void store_sizes_x4(std::uint8_t* out, __m256i sizes) noexcept {
+    const __m256i bytes = _mm256_shuffle_epi8(
+        sizes, _mm256_setr_epi8(0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+                                -1, -1, 0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+    const int packed = _mm_cvtsi128_si32(
+        _mm_or_si128(_mm256_castsi256_si128(bytes), _mm256_extracti128_si256(bytes, 1)));
+    std::memcpy(out, &packed, 4);
+}
+#endif
+
+// Stores the size of each value as written by cat() (the digits, and the '-' sign of negative
+// values) in out[0], ..., out[values.size() - 1].  32-bit and 64-bit integers are processed 8 or 4
+// at a time with AVX2.
+template <typename T>
+void digit_counts(std::span<const T> values, std::uint8_t* out) noexcept {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    const size_t n = values.size();
+    size_t i = 0;
+#if defined(LAZYCAT_HAS_AVX2)
+    if constexpr (sizeof(T) == 4) {
+        for (; i + 8 <= n; i += 8) store_sizes_x8(out + i, integral_sizes_x8(values.data() + i));
+    } else if constexpr (sizeof(T) == 8) {
+        for (; i + 4 <= n; i += 4) store_sizes_x4(out + i, integral_sizes_x4(values.data() + i));
+    }
+#endif
+    for (; i != n; ++i) {
+        out[i] = static_cast<std::uint8_t>(
+            calculate_integral_size<std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1>(
+                values[i]));
+    }
+}
+
+// The total size of the values as written by cat().
+template <typename T>
+size_t total_size(std::span<const T> values) noexcept {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    const size_t n = values.size();
+    size_t i = 0, ret = 0;
+#if defined(LAZYCAT_HAS_AVX2)
+    if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
+        __m256i sums = _mm256_setzero_si256();  // in 64-bit lanes
+        if constexpr (sizeof(T) == 4) {
+            for (; i + 8 <= n; i += 8) {
+                // Adds the bytes of each 64-bit lane (the sizes are at most 11)
+                sums = _mm256_add_epi64(
+                    sums, _mm256_sad_epu8(integral_sizes_x8(values.data() + i),
+                                          _mm256_setzero_si256()));
+            }
+        } else {
+            for (; i + 4 <= n; i += 4) {
+                sums = _mm256_add_epi64(sums, integral_sizes_x4(values.data() + i));
+            }
+        }
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+        ret = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+#endif
+    for (; i != n; ++i) {
+        ret += calculate_integral_size<std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1>(
+            values[i]);
+    }
+    return ret;
+}
+
+// Whether all 8 bytes of a word (loaded little-endian from 8 chars) are ASCII digits.
+inline LAZYCAT_FORCEINLINE bool is_8_digits(std::uint64_t word) noexcept {
+    const std::uint64_t x = word ^ 0x3030303030303030;  // digits become 0..9
+    // The top bit of each byte is set if the byte is >= 10 (the masked addition cannot carry)
+    return ((((x & 0x7F7F7F7F7F7F7F7F) + 0x7676767676767676) | x) & 0x8080808080808080) == 0;
+}
+
+// Parses the 8 digits of such a word, with one multiply and shift per step: pairs of digits, then
+// groups of four, then all eight.
+inline LAZYCAT_FORCEINLINE std::uint64_t parse_8_digits(std::uint64_t word) noexcept {
+    word -= 0x3030303030303030;
+    word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FF;
+    word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFF;
+    return (word * 10000 + (word >> 32)) & 0xFFFFFFFF;
+}
+
+#if defined(LAZYCAT_HAS_AVX2)
+// Parses 16 digits at once (the SSSE3 and SSE4.1 instructions used here come with AVX2).  Returns
+// false if the 16 bytes at p are not all digits.
+inline LAZYCAT_FORCEINLINE bool parse_16_digits(const char* p, std::uint64_t& value) noexcept {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i digits = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+    // Digits become 0..9 and everything else wraps around to 10..255
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    if (_mm_movemask_epi8(is_digit) != 0xFFFF) return false;
+    const __m128i pairs = _mm_maddubs_epi16(digits, _mm_set1_epi16(0x010A));   // 10, 1
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010064));    // 100, 1
+    const __m128i packed = _mm_packus_epi32(quads, quads);
+    const __m128i octets = _mm_madd_epi16(packed, _mm_set1_epi32(0x00012710));  // 10000, 1
+    const auto hi = static_cast<std::uint32_t>(_mm_cvtsi128_si32(octets));
+    const auto lo = static_cast<std::uint32_t>(_mm_extract_epi32(octets, 1));
+    value = std::uint64_t{hi} * 100000000 + lo;
+    return true;
+}
+#endif
+
+struct parsed_digits {
+    const char* ptr;  // after the last digit
+    bool any;         // whether there was at least one digit
+    bool overflow;    // whether the value does not fit in 64 bits
+    std::uint64_t value;
+};
+
+inline bool is_digit(char c) noexcept { return static_cast<unsigned char>(c - '0') < 10; }
+
+// value = value * 10^count + chunk, where value had `digits` digits before.  Returns false if the
+// result does not fit in 64 bits.
+inline LAZYCAT_FORCEINLINE bool append_digits(std::uint64_t& value, unsigned& digits,
+                                              std::uint64_t chunk, unsigned count) noexcept {
+    constexpr unsigned max_digits = std::numeric_limits<std::uint64_t>::digits10 + 1;
+    digits += count;
+    const std::uint64_t scale = powers_of_10_minus_1<std::uint64_t>[count] + 1;
+    if (digits < max_digits) {
+        value = value * scale + chunk;
+        return true;
+    }
+    if (digits > max_digits) return false;
+#if defined(__GNUC__)
+    return !__builtin_mul_overflow(value, scale, &value) &&
+           !__builtin_add_overflow(value, chunk, &value);
+#else
+    if (value > (std::numeric_limits<std::uint64_t>::max() - chunk) / scale) return false;
+    value = value * scale + chunk;
+    return true;
+#endif
+}
+
+// Parses a run of decimal digits into a 64-bit value: blocks of 8 digits (16 with AVX2) at once,
+// then the remaining (at most 7) digits in a plain loop, which keeps short numbers as fast as a
+// simple loop.  Leading zeros are only skipped if there seem to be too many digits, which keeps
+// them off the common path.
+inline LAZYCAT_FORCEINLINE parsed_digits parse_digits(const char* first,
+                                                      const char* last) noexcept {
+    const char* const start = first;
+    const char* p;
+    for (;;) {
+        p = first;
+        std::uint64_t value = 0;
+        unsigned digits = 0;
+        bool ok = true;
+#if defined(LAZYCAT_HAS_AVX2)
+        if (last - p >= 16 && parse_16_digits(p, value)) {
+            digits = 16;
+            p += 16;
+        }
+#endif
+        for (std::uint64_t word;
+             ok && last - p >= 8 && (std::memcpy(&word, p, 8), is_8_digits(word)); p += 8) {
+            ok = append_digits(value, digits, parse_8_digits(word), 8);
+        }
+        if (ok) {
+            const char* const tail = p;
+            std::uint64_t tail_value = 0;
+            for (unsigned d; p != last && (d = static_cast<unsigned char>(*p - '0')) < 10; ++p) {
+                tail_value = tail_value * 10 + d;
+            }
+            const auto tail_digits = static_cast<unsigned>(p - tail);
+            if (tail_digits == 0 || append_digits(value, digits, tail_value, tail_digits)) {
+                return {p, p != start, false, value};
+            }
+        }
+        if (*first != '0') break;
+        // Too many digits, but only counting leading zeros: skip them and start again (if only
+        // zeros remain, the next round parses nothing and returns 0 at last)
+        while (first != last && *first == '0') ++first;
+    }
+    // Too many digits: the result still ends after the last one
+    while (p != last && is_digit(*p)) ++p;
+    return {p, true, true, 0};
+}
+
+}  // namespace detail
+
+// Parses a decimal integer from [first, last), with the same syntax and results as
+// std::from_chars(first, last, value) (an optional '-' for signed types, no '+', no whitespace),
+// but several digits at a time.
+template <typename T>
+inline LAZYCAT_FORCEINLINE std::from_chars_result parse_integral(const char* first,
+                                                                 const char* last,
+                                                                 T& value) noexcept {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+    using U = std::make_unsigned_t<T>;
+    if constexpr (std::endian::native != std::endian::little ||
+                  std::numeric_limits<U>::digits > std::numeric_limits<std::uint64_t>::digits) {
+        return std::from_chars(first, last, value);
+    } else {
+        const bool negative = std::is_signed_v<T> && first != last && *first == '-';
+        const detail::parsed_digits d = detail::parse_digits(first + negative, last);
+        if (!d.any) return {first, std::errc::invalid_argument};
+        // The magnitude of the minimum value of a signed type is one more than the maximum value
+        const std::uint64_t limit =
+            static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + negative;
+        if (d.overflow || d.value > limit) return {d.ptr, std::errc::result_out_of_range};
+        value = negative ? static_cast<T>(U{0} - static_cast<U>(d.value)) : static_cast<T>(d.value);
+        return {d.ptr, std::errc{}};
+    }
+}
+
 }  // namespace lazycat
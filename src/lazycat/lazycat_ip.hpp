@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/lazycat_hex.hpp>
+#include <lazycat/util.hpp>
+#include <span>
+
+// This file contains writers for IP addresses:
+//   ipv4(addr)   dotted decimal, where addr is in host byte order (0xC0A80001 is "192.168.0.1")
+//   ipv6(bytes)  the canonical text form from RFC 5952: lowercase, no leading zeros, the longest
+//                run of two or more zero groups replaced by "::", and IPv4-mapped addresses
+//                written as "::ffff:a.b.c.d"
+// bytes are in network byte order, as in in6_addr.
+
+namespace lazycat {
+
+namespace detail {
+
+// The decimal representation of each octet, and its length
+struct ipv4_octet {
+    char chars[3];
+    std::uint8_t size;
+};
+
+static constexpr std::array<ipv4_octet, 256> ipv4_octets = []() {
+    std::array<ipv4_octet, 256> octets{};
+    for (unsigned i = 0; i != 256; ++i) {
+        ipv4_octet& octet = octets[i];
+        if (i >= 100) octet.chars[octet.size++] = static_cast<char>('0' + i / 100);
+        if (i >= 10) octet.chars[octet.size++] = static_cast<char>('0' + i / 10 % 10);
+        octet.chars[octet.size++] = static_cast<char>('0' + i % 10);
+    }
+    return octets;
+}();
+
+constexpr size_t ipv4_size(std::uint32_t addr) noexcept {
+    return 3 + ipv4_octets[addr >> 24].size + ipv4_octets[(addr >> 16) & 0xFF].size +
+           ipv4_octets[(addr >> 8) & 0xFF].size + ipv4_octets[addr & 0xFF].size;
+}
+
+template <typename CharT>
+constexpr CharT* write_ipv4(CharT* out, std::uint32_t addr) noexcept {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        const ipv4_octet& octet = ipv4_octets[(addr >> shift) & 0xFF];
+        for (size_t i = 0; i != octet.size; ++i) *out++ = static_cast<CharT>(octet.chars[i]);
+        if (shift != 0) *out++ = static_cast<CharT>('.');
+    }
+    return out;
+}
+
+constexpr size_t hex_group_size(std::uint16_t group) noexcept {
+    return group == 0 ? 1 : (std::bit_width(group) + 3) / 4;
+}
+
+template <typename CharT>
+constexpr CharT* write_hex_group(CharT* out, std::uint16_t group) noexcept {
+    for (size_t i = hex_group_size(group); i-- != 0;) {
+        *out++ = static_cast<CharT>(hex_digits[(group >> (i * 4)) & 0x0F]);
+    }
+    return out;
+}
+
+}  // namespace detail
+
+struct ipv4_writer : public base_writer {
+    std::uint32_t content;
+    constexpr size_t size() const noexcept { return detail::ipv4_size(content); }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        return detail::write_ipv4(out, content);
+    }
+};
+
+struct ipv6_writer : public base_writer {
+    std::array<std::uint8_t, 16> content;
+    // The longest run of zero groups (cached by size())
+    mutable std::uint8_t cached_zero_run_start;
+    mutable std::uint8_t cached_zero_run_size;
+
+    constexpr std::uint16_t group(size_t i) const noexcept {
+        return static_cast<std::uint16_t>(content[i * 2] << 8 | content[i * 2 + 1]);
+    }
+    constexpr bool is_ipv4_mapped() const noexcept {
+        for (size_t i = 0; i != 10; ++i) {
+            if (content[i] != 0) return false;
+        }
+        return content[10] == 0xFF && content[11] == 0xFF;
+    }
+    constexpr std::uint32_t mapped_ipv4() const noexcept {
+        return std::uint32_t{content[12]} << 24 | std::uint32_t{content[13]} << 16 |
+               std::uint32_t{content[14]} << 8 | std::uint32_t{content[15]};
+    }
+
+    constexpr size_t size() const noexcept {
+        if (is_ipv4_mapped()) return 7 + detail::ipv4_size(mapped_ipv4());  // "::ffff:"
+        size_t best_start = 0, best_size = 0;
+        size_t sz = 0;
+        for (size_t i = 0; i != 8;) {
+            if (group(i) != 0) {
+                sz += detail::hex_group_size(group(i));
+                ++i;
+                continue;
+            }
+            const size_t start = i;
+            while (i != 8 && group(i) == 0) ++i;
+            sz += i - start;  // each zero group is a single '0' if not compressed
+            if (i - start > best_size) {
+                best_start = start;
+                best_size = i - start;
+            }
+        }
+        if (best_size < 2) best_size = 0;  // a single zero group is not compressed
+        cached_zero_run_start = static_cast<std::uint8_t>(best_start);
+        cached_zero_run_size = static_cast<std::uint8_t>(best_size);
+        if (best_size == 0) return sz + 7;
+        const size_t left = best_start, right = 8 - best_start - best_size;
+        return sz - best_size + (left != 0 ? left - 1 : 0) + 2 + (right != 0 ? right - 1 : 0);
+    }
+
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        if (is_ipv4_mapped()) {
+            constexpr char prefix[] = "::ffff:";
+            out = detail::copy_chars(prefix, 7, out);
+            return detail::write_ipv4(out, mapped_ipv4());
+        }
+        const size_t run_start = cached_zero_run_start;
+        const size_t run_end = run_start + cached_zero_run_size;
+        for (size_t i = 0; i != 8; ++i) {
+            if (cached_zero_run_size != 0 && i == run_start) {
+                *out++ = static_cast<CharT>(':');
+                *out++ = static_cast<CharT>(':');
+                i = run_end - 1;
+                continue;
+            }
+            if (i != 0 && !(cached_zero_run_size != 0 && i == run_end)) {
+                *out++ = static_cast<CharT>(':');
+            }
+            out = detail::write_hex_group(out, group(i));
+        }
+        return out;
+    }
+};
+
+[[nodiscard]] constexpr ipv4_writer ipv4(std::uint32_t addr) noexcept {
+    return ipv4_writer{{}, addr};
+}
+
+[[nodiscard]] constexpr ipv6_writer ipv6(std::span<const std::uint8_t, 16> bytes) noexcept {
+    ipv6_writer ret{{}, {}, 0, 0};
+    for (size_t i = 0; i != 16; ++i) ret.content[i] = bytes[i];
+    return ret;
+}
+
+}  // namespace lazycat
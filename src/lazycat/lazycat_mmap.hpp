@@ -0,0 +1,178 @@
+#pragma once
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+#define LAZYCAT_HAS_MMAP
+#endif
+
+#if defined(LAZYCAT_HAS_MMAP)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <lazycat/lazycat_core.hpp>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+// This file contains mmap_file_sink, which writes cat() records straight into a memory-mapped
+// output file (POSIX only; LAZYCAT_HAS_MMAP is defined when it is available):
+//
+//   lazycat::mmap_file_sink out;
+//   if (!out.open("export.csv")) ...;  // out.error() is the errno value
+//   for (const auto& row : rows) lazycat::cat_into(out, row.id, ',', row.name, '\n');
+//   out.close();  // truncates the file to the bytes written
+//
+// Since size() is known before write(), each record is written in place with no intermediate
+// string and no syscall.  The file grows in extents (allocated with fallocate where available, so
+// that a full disk is reported as an error instead of a SIGBUS), and only one extent is mapped at
+// a time.  Every flush_interval bytes the written pages are handed to the kernel for writeback
+// (msync with MS_ASYNC) and dropped from the mapping (MADV_DONTNEED), which bounds the resident
+// size to about flush_interval bytes.
+
+namespace lazycat {
+
+class mmap_file_sink {
+   public:
+    mmap_file_sink() = default;
+    mmap_file_sink(const mmap_file_sink&) = delete;
+    mmap_file_sink& operator=(const mmap_file_sink&) = delete;
+    ~mmap_file_sink() { close(); }
+
+    // Creates or truncates the file at `path`.  The extent and the flush interval are rounded up
+    // to whole pages.  Returns false on failure, with the errno value in error().
+    bool open(const char* path, size_t extent = size_t{64} << 20,
+              size_t flush_interval = size_t{16} << 20) noexcept {
+        close();
+        error_ = 0;
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        extent_ = round_up(std::max(extent, page), page);
+        flush_interval_ = round_up(std::max(flush_interval, page), page);
+        page_ = page;
+        fd_ = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return fd_ >= 0 || fail();
+    }
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    // The errno value of the last failure, or 0.
+    int error() const noexcept { return error_; }
+    // The number of bytes written so far.
+    size_t size() const noexcept { return size_; }
+
+    // Returns a pointer to `n` writable bytes at the end of the file, or nullptr on failure.  The
+    // bytes become part of the file with commit(n).
+    char* reserve(size_t n) noexcept {
+        if ((!window_ || size_ + n > window_offset_ + window_size_) && !remap(n)) return nullptr;
+        return window_ + (size_ - window_offset_);
+    }
+
+    void commit(size_t n) noexcept {
+        size_ += n;
+        if (size_ - flushed_ >= flush_interval_) flush(round_down(size_, page_));
+    }
+
+    // Unmaps the file, truncates it to size() and closes it.  Returns false on failure.
+    bool close() noexcept {
+        if (fd_ < 0) return true;
+        unmap();
+        bool ok = ::ftruncate(fd_, static_cast<off_t>(size_)) == 0 || fail();
+        ok = (::close(fd_) == 0 || fail()) && ok;
+        fd_ = -1;
+        size_ = file_size_ = flushed_ = 0;
+        return ok;
+    }
+
+   private:
+    static size_t round_up(size_t n, size_t align) noexcept {
+        return (n + align - 1) / align * align;
+    }
+    static size_t round_down(size_t n, size_t align) noexcept { return n / align * align; }
+
+    bool fail() noexcept {
+        error_ = errno;
+        return false;
+    }
+
+    // Maps a new window that starts at the page containing size_ and holds at least n bytes
+    // after it, growing the file first if needed.
+    bool remap(size_t n) noexcept {
+        if (fd_ < 0) {
+            error_ = EBADF;
+            return false;
+        }
+        unmap();
+        const size_t offset = round_down(size_, page_);
+        const size_t length = std::max(extent_, round_up(size_ - offset + n, page_));
+        if (offset + length > file_size_ && !grow(offset + length)) return false;
+        void* const p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                               static_cast<off_t>(offset));
+        if (p == MAP_FAILED) return fail();
+        ::madvise(p, length, MADV_SEQUENTIAL);
+        window_ = static_cast<char*>(p);
+        window_offset_ = offset;
+        window_size_ = length;
+        flushed_ = std::max(flushed_, offset);
+        return true;
+    }
+
+    bool grow(size_t new_size) noexcept {
+#if defined(__linux__)
+        // Allocates the blocks, so that writing to the mapping cannot fail later.  File systems
+        // without fallocate fall back to ftruncate.
+        if (::fallocate(fd_, 0, static_cast<off_t>(file_size_),
+                        static_cast<off_t>(new_size - file_size_)) == 0) {
+            file_size_ = new_size;
+            return true;
+        }
+        if (errno != EOPNOTSUPP && errno != ENOSYS) return fail();
+#endif
+        if (::ftruncate(fd_, static_cast<off_t>(new_size)) != 0) return fail();
+        file_size_ = new_size;
+        return true;
+    }
+
+    // Starts writeback of the written pages in [flushed_, end) and drops them from the mapping.
+    void flush(size_t end) noexcept {
+        if (end <= flushed_ || !window_) return;
+        char* const begin = window_ + (flushed_ - window_offset_);
+        ::msync(begin, end - flushed_, MS_ASYNC);
+        ::madvise(begin, end - flushed_, MADV_DONTNEED);
+        flushed_ = end;
+    }
+
+    void unmap() noexcept {
+        if (!window_) return;
+        ::msync(window_, window_size_, MS_ASYNC);
+        ::munmap(window_, window_size_);
+        window_ = nullptr;
+        window_offset_ = window_size_ = 0;
+    }
+
+    int fd_ = -1;
+    int error_ = 0;
+    size_t page_ = 4096;
+    size_t extent_ = 0;
+    size_t flush_interval_ = 0;
+    char* window_ = nullptr;
+    size_t window_offset_ = 0;  // file offset of window_
+    size_t window_size_ = 0;
+    size_t size_ = 0;       // bytes written
+    size_t file_size_ = 0;  // bytes allocated
+    size_t flushed_ = 0;    // end of the pages already flushed
+};
+
+// Appends the concatenation of ss... to the file.  Returns false on failure.
+template <typename... Ss>
+bool cat_into(mmap_file_sink& file, Ss&&... ss) noexcept {
+    const auto c = cat(std::forward<Ss>(ss)...);
+    const size_t sz = c.size();
+    char* const out = file.reserve(sz);
+    if (!out) return false;
+    c.write(out);
+    file.commit(sz);
+    return true;
+}
+
+}  // namespace lazycat
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/util.hpp>
+#include <string_view>
+
+// This file contains writers for repeated content, for indentation, separators and padding:
+//   fill(ch, n)    writes n copies of the character ch
+//   repeat(s, n)   writes n copies of the string s
+// Both have O(1) size().  fill() is a single memset for one-byte output characters, and repeat()
+// writes s once and then doubles the written prefix with memcpy until it is done.  The same width
+// rules as basic_char_writer and basic_string_view_writer apply, so in wider output, narrow
+// non-ASCII code units become U+FFFD (an O(1) size() cannot decode UTF-8).
+
+namespace lazycat {
+
+namespace detail {
+
+// Converts a code unit to OutCharT (widening narrow characters with widen_char, as in copy_chars).
+template <typename OutCharT, typename CharT>
+constexpr OutCharT convert_char(CharT ch) noexcept {
+    static_assert(sizeof(CharT) == sizeof(OutCharT) || sizeof(CharT) == 1,
+                  "Only same-width copies and widening of narrow chars are supported");
+    if constexpr (sizeof(CharT) == sizeof(OutCharT)) {
+        return static_cast<OutCharT>(ch);
+    } else {
+        return widen_char<OutCharT>(ch);
+    }
+}
+
+template <typename CharT>
+constexpr CharT* fill_chars(CharT* out, size_t count, CharT ch) noexcept {
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+    if (std::is_constant_evaluated()) return std::fill_n(out, count, ch);
+#endif
+    if constexpr (sizeof(CharT) == 1) {
+        std::memset(out, static_cast<unsigned char>(ch), count);
+        return out + count;
+    } else {
+        return std::fill_n(out, count, ch);  // vectorized by the compiler
+    }
+}
+
+}  // namespace detail
+
+template <typename CharT>
+struct fill_writer : public base_writer {
+    CharT content;
+    size_t count;
+    constexpr size_t size() const noexcept { return count; }
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        return detail::fill_chars(out, count, detail::convert_char<OutCharT>(content));
+    }
+};
+
+template <typename CharT>
+struct repeat_writer : public base_writer {
+    std::basic_string_view<CharT> content;
+    size_t count;
+    constexpr size_t size() const noexcept { return content.size() * count; }
+    template <typename OutCharT>
+    constexpr OutCharT* write(OutCharT* out) const noexcept {
+        if (content.size() == 1) {
+            return detail::fill_chars(out, count, detail::convert_char<OutCharT>(content[0]));
+        }
+        const size_t total = content.size() * count;
+        if (total == 0) return out;
+        detail::copy_chars(content.data(), content.size(), out);
+        // Double the written prefix until everything is written
+        for (size_t done = content.size(); done != total;) {
+            const size_t chunk = std::min(done, total - done);
+            detail::copy_chars(out, chunk, out + done);
+            done += chunk;
+        }
+        return out + total;
+    }
+};
+
+template <typename CharT>
+[[nodiscard]] constexpr fill_writer<CharT> fill(CharT ch, size_t count) noexcept {
+    return fill_writer<CharT>{{}, ch, count};
+}
+
+[[nodiscard]] constexpr repeat_writer<char> repeat(std::string_view s, size_t count) noexcept {
+    return repeat_writer<char>{{}, s, count};
+}
+
+[[nodiscard]] constexpr repeat_writer<wchar_t> repeat(std::wstring_view s, size_t count) noexcept {
+    return repeat_writer<wchar_t>{{}, s, count};
+}
+
+#if defined(__cpp_char8_t)
+[[nodiscard]] constexpr repeat_writer<char8_t> repeat(std::u8string_view s, size_t count) noexcept {
+    return repeat_writer<char8_t>{{}, s, count};
+}
+#endif
+
+[[nodiscard]] constexpr repeat_writer<char16_t> repeat(std::u16string_view s,
+                                                       size_t count) noexcept {
+    return repeat_writer<char16_t>{{}, s, count};
+}
+
+[[nodiscard]] constexpr repeat_writer<char32_t> repeat(std::u32string_view s,
+                                                       size_t count) noexcept {
+    return repeat_writer<char32_t>{{}, s, count};
+}
+
+}  // namespace lazycat
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <lazycat/lazycat_core.hpp>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+// This file contains ring_sink, a lock-free byte ring for assembling log lines from many threads,
+// and cat_into(ring, ...), which writes a cat() expression directly into it:
+//
+//   lazycat::ring_sink ring(1 << 20);
+//   // producers (any number of threads):
+//   lazycat::cat_into(ring, "GET ", path, ' ', status, ' ', elapsed_ms, "ms\n");
+//   // consumer (one thread):
+//   ring.drain_to(file);
+//
+// A producer computes size(), reserves that many bytes with a single fetch_add on the write
+// position, writes into the reserved bytes and commits them; it never allocates or locks.  A
+// reservation that would cross the end of the buffer is turned into padding and retried, so every
+// message is contiguous.  When the ring is full, cat_into() waits for the consumer to make room,
+// and try_cat_into() returns false instead.  Messages are delivered in the order of their
+// reservations.  Only one thread may consume at a time; any number of threads may produce.
+
+namespace lazycat {
+
+class ring_sink {
+   public:
+    // The largest capacity, so that the span of a record always fits in its header.
+    static constexpr size_t max_capacity = size_t{1} << 31;
+
+    // The capacity is rounded up to a power of two (at least 64 bytes), and clamped to
+    // max_capacity.
+    explicit ring_sink(size_t capacity)
+        : capacity_(round_capacity(capacity)),
+          buffer_(std::make_unique<std::uint64_t[]>(capacity_ / sizeof(std::uint64_t))) {}
+    ring_sink(const ring_sink&) = delete;
+    ring_sink& operator=(const ring_sink&) = delete;
+
+    size_t capacity() const noexcept { return capacity_; }
+    // The largest message that fits.
+    size_t max_message_size() const noexcept { return capacity_ - sizeof(header); }
+
+    // A reserved region of `size` bytes at `data`, which must be committed after it is written.
+    struct reservation {
+        char* data;
+        size_t size;
+        std::uint64_t position;
+    };
+
+    // Reserves `size` bytes, waiting for the consumer if the ring is full.  Returns a null data
+    // pointer if the message can never fit.
+    reservation reserve(size_t size) noexcept {
+        if (size > max_message_size()) return {nullptr, size, 0};
+        const std::uint64_t span = record_span(size);
+        for (;;) {
+            const std::uint64_t pos = write_.fetch_add(span, std::memory_order_relaxed);
+            wait_for_space(pos + span);
+            if (fits_before_end(pos, span)) return start_record(pos, span, size);
+            commit_padding(pos, span);
+        }
+    }
+
+    // Like reserve(), but returns a null data pointer instead of waiting if the ring is full.
+    reservation try_reserve(size_t size) noexcept {
+        if (size > max_message_size()) return {nullptr, size, 0};
+        const std::uint64_t span = record_span(size);
+        std::uint64_t pos = write_.load(std::memory_order_relaxed);
+        for (;;) {
+            // If the record would cross the end, the padding up to the end is reserved with it.
+            const std::uint64_t padding = fits_before_end(pos, span) ? 0 : capacity_ - offset(pos);
+            if (pos + padding + span - read_.load(std::memory_order_acquire) > capacity_) {
+                return {nullptr, size, 0};
+            }
+            const std::uint64_t end = pos + padding + span;
+            if (write_.compare_exchange_weak(pos, end, std::memory_order_relaxed)) {
+                if (padding != 0) commit_padding(pos, padding);
+                return start_record(pos + padding, span, size);
+            }
+        }
+    }
+
+    // Publishes a written reservation to the consumer.
+    void commit(const reservation& r) noexcept {
+        header_at(r.position)->length = static_cast<std::uint32_t>(r.size);
+        publish(r.position);
+    }
+
+    // Consumer: calls f(std::string_view) for each committed message, in order, until it reaches
+    // one that is not committed yet.  Returns the number of messages.
+    template <typename F>
+    size_t drain(F&& f) {
+        std::uint64_t pos = read_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        for (;;) {
+            header* const h = header_at(pos);
+            if (std::atomic_ref<std::uint64_t>(h->tag).load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            const std::uint32_t span = h->span;
+            if (h->length != padding_length) {
+                f(std::string_view(reinterpret_cast<const char*>(h + 1), h->length));
+                ++count;
+            }
+            // Clears the record before it is reused, so that stale message bytes are never taken
+            // for a committed header on the next lap (headers of the next lap may start anywhere
+            // in it).  Producers only write to it after the store to read_.
+            clear(pos, span);
+            pos += span;
+            read_.store(pos, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Consumer: writes all committed messages to `file`.
+    size_t drain_to(std::FILE* file) {
+        return drain([file](std::string_view message) {
+            std::fwrite(message.data(), 1, message.size(), file);
+        });
+    }
+
+   private:
+    // Each record starts with a header and is aligned to 16 bytes, so that a header always fits
+    // before the end of the buffer.
+    struct header {
+        std::uint64_t tag;     // position + 1 once committed (never 0 for an uncommitted record)
+        std::uint32_t span;    // bytes from this header to the next one
+        std::uint32_t length;  // message length, or padding_length
+    };
+    static_assert(sizeof(header) == 16);
+    static constexpr std::uint32_t padding_length = 0xFFFFFFFF;
+    static constexpr size_t cache_line = 64;
+
+    static size_t round_capacity(size_t capacity) noexcept {
+        size_t ret = 64;
+        while (ret < capacity && ret < max_capacity) ret *= 2;
+        return ret;
+    }
+    static std::uint64_t record_span(size_t size) noexcept {
+        return (sizeof(header) + size + 15) & ~std::uint64_t{15};
+    }
+    size_t offset(std::uint64_t pos) const noexcept { return pos & (capacity_ - 1); }
+    bool fits_before_end(std::uint64_t pos, std::uint64_t span) const noexcept {
+        return offset(pos) + span <= capacity_;
+    }
+    header* header_at(std::uint64_t pos) const noexcept {
+        return reinterpret_cast<header*>(reinterpret_cast<char*>(buffer_.get()) + offset(pos));
+    }
+
+    void wait_for_space(std::uint64_t end) const noexcept {
+        for (unsigned spins = 0; end - read_.load(std::memory_order_acquire) > capacity_; ++spins) {
+            if (spins >= 64) std::this_thread::yield();
+        }
+    }
+    reservation start_record(std::uint64_t pos, std::uint64_t span, size_t size) noexcept {
+        header* const h = header_at(pos);
+        h->span = static_cast<std::uint32_t>(span);
+        return {reinterpret_cast<char*>(h + 1), size, pos};
+    }
+    void commit_padding(std::uint64_t pos, std::uint64_t span) noexcept {
+        header* const h = header_at(pos);
+        h->span = static_cast<std::uint32_t>(span);
+        h->length = padding_length;
+        publish(pos);
+    }
+    // Zeroes span bytes from pos (padding reserved by reserve() may wrap around the end).
+    void clear(std::uint64_t pos, std::uint64_t span) noexcept {
+        char* const buffer = reinterpret_cast<char*>(buffer_.get());
+        const size_t first = std::min<size_t>(span, capacity_ - offset(pos));
+        std::memset(buffer + offset(pos), 0, first);
+        std::memset(buffer, 0, span - first);
+    }
+    void publish(std::uint64_t pos) noexcept {
+        std::atomic_ref<std::uint64_t> tag(header_at(pos)->tag);
+        tag.store(pos + 1, std::memory_order_release);
+    }
+
+    const size_t capacity_;
+    // Zeroed, and cleared again by drain(), so that no record looks committed before it is
+    const std::unique_ptr<std::uint64_t[]> buffer_;
+    alignas(cache_line) std::atomic<std::uint64_t> write_{0};  // next position to reserve
+    alignas(cache_line) std::atomic<std::uint64_t> read_{0};   // next position to consume
+};
+
+// Writes the concatenation of ss... into the ring as one message, waiting if the ring is full.
+// Returns false if the message is larger than ring.max_message_size().
+template <typename... Ss>
+bool cat_into(ring_sink& ring, Ss&&... ss) noexcept {
+    const auto c = cat(std::forward<Ss>(ss)...);
+    const ring_sink::reservation r = ring.reserve(c.size());
+    if (!r.data) return false;
+    c.write(r.data);
+    ring.commit(r);
+    return true;
+}
+
+// Like cat_into(), but returns false instead of waiting if the ring is full.
+template <typename... Ss>
+bool try_cat_into(ring_sink& ring, Ss&&... ss) noexcept {
+    const auto c = cat(std::forward<Ss>(ss)...);
+    const ring_sink::reservation r = ring.try_reserve(c.size());
+    if (!r.data) return false;
+    c.write(r.data);
+    ring.commit(r);
+    return true;
+}
+
+}  // namespace lazycat
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/lazycat_integral.hpp>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// This file contains the parsing counterparts of the writers: scan(), which parses a line written
+// by cat() back into variables, and split(), which iterates over the fields of a line.  Neither
+// allocates.
+//
+//   int id;
+//   double price;
+//   std::string_view name;
+//   if (auto r = lazycat::scan(line, id, ',', name, ',', price); r && r.rest.empty()) ...
+//
+//   for (std::string_view field : lazycat::split(line, '\t')) ...
+//
+// Each argument of scan() is either an output or a literal:
+// - Non-const lvalues of arithmetic types other than char are outputs, parsed with the same
+//   syntax as their writers produce (parse_integral() for integers, std::from_chars for floating
+//   point numbers, and '0' or '1' for bools).
+// - Non-const lvalues of type std::string_view are outputs.  They take everything up to the next
+//   argument (which must then be a literal), or the rest of the input if they are last.
+// - Everything else (chars, and anything convertible to std::string_view, including const
+//   std::string_view) is a literal that must match exactly.
+// Delimiters are found with AVX2 or SSE2 where available.
+
+// Floating point numbers are parsed with std::from_chars, which some standard libraries lack (e.g.
+// older libc++); scanning float or double is then a compile error.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define LAZYCAT_HAS_FLOATING_POINT_SCAN
+#endif
+
+namespace lazycat {
+
+namespace detail {
+
+// Returns the first occurrence of c in [first, last), or last.  The first 64 bytes are searched
+// inline, which is what matters for typical fields; the rest is left to memchr, which the C
+// library usually dispatches at runtime to the widest vector instructions available.
+inline const char* find_char(const char* first, const char* last, char c) noexcept {
+    const char* const inline_last = last - first > 64 ? first + 64 : last;
+#if defined(LAZYCAT_HAS_AVX2)
+    const __m256i needle32 = _mm256_set1_epi8(c);
+    for (; inline_last - first >= 32; first += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const auto mask =
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle32)));
+        if (mask != 0) return first + std::countr_zero(mask);
+    }
+#endif
+#if defined(LAZYCAT_HAS_SSE2)
+    const __m128i needle16 = _mm_set1_epi8(c);
+    for (; inline_last - first >= 16; first += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle16)));
+        if (mask != 0) return first + std::countr_zero(mask);
+    }
+#endif
+    for (; first != inline_last; ++first) {
+        if (*first == c) return first;
+    }
+    if (first == last) return last;
+    const void* const found = std::memchr(first, c, static_cast<size_t>(last - first));
+    return found ? static_cast<const char*>(found) : last;
+}
+
+// Marks the end of the arguments of scan().
+struct scan_end {};
+
+template <typename T>
+using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <typename S, typename T = remove_cvref_t<S>>
+constexpr bool is_scan_output_v =
+    std::is_lvalue_reference_v<S> && !std::is_const_v<std::remove_reference_t<S>> &&
+    ((std::is_arithmetic_v<T> && !std::is_same_v<T, char>) || std::is_same_v<T, std::string_view>);
+
+template <typename T>
+bool scan_number(std::string_view& in, T& out) noexcept {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (in.empty() || (in[0] != '0' && in[0] != '1')) return false;
+        out = in[0] == '1';
+        in.remove_prefix(1);
+        return true;
+    } else if constexpr (std::is_integral_v<T>) {
+        const auto [ptr, ec] = parse_integral(in.data(), in.data() + in.size(), out);
+        if (ec != std::errc{}) return false;
+        in.remove_prefix(static_cast<size_t>(ptr - in.data()));
+        return true;
+    } else {
+#if !defined(LAZYCAT_HAS_FLOATING_POINT_SCAN)
+        static_assert(!std::is_floating_point_v<T>,
+                      "Scanning floating point numbers needs std::from_chars");
+#endif
+        const auto [ptr, ec] = std::from_chars(in.data(), in.data() + in.size(), out);
+        if (ec != std::errc{}) return false;
+        in.remove_prefix(static_cast<size_t>(ptr - in.data()));
+        return true;
+    }
+}
+
+// Returns the position of the literal in `in`, or npos.
+inline size_t find_literal(std::string_view in, char c) noexcept {
+    const char* const found = find_char(in.data(), in.data() + in.size(), c);
+    return found == in.data() + in.size() ? std::string_view::npos
+                                          : static_cast<size_t>(found - in.data());
+}
+inline size_t find_literal(std::string_view in, std::string_view s) noexcept { return in.find(s); }
+
+inline bool match_literal(std::string_view& in, char c) noexcept {
+    if (in.empty() || in[0] != c) return false;
+    in.remove_prefix(1);
+    return true;
+}
+inline bool match_literal(std::string_view& in, std::string_view s) noexcept {
+    if (in.substr(0, s.size()) != s) return false;
+    in.remove_prefix(s.size());
+    return true;
+}
+
+// Scans one argument of type S (as passed to scan()), followed by an argument of type Next.
+template <typename S, typename Next>
+bool scan_one(std::string_view& in, std::remove_reference_t<S>& arg,
+              [[maybe_unused]] const std::remove_reference_t<Next>& next) noexcept {
+    using T = remove_cvref_t<S>;
+    if constexpr (is_scan_output_v<S> && std::is_same_v<T, std::string_view>) {
+        static_assert(!is_scan_output_v<Next>,
+                      "A std::string_view output must be followed by a literal, or be last");
+        if constexpr (std::is_same_v<remove_cvref_t<Next>, scan_end>) {
+            arg = in;
+            in = {};
+        } else {
+            const size_t pos = find_literal(in, next);
+            if (pos == std::string_view::npos) return false;
+            arg = in.substr(0, pos);
+            in.remove_prefix(pos);
+        }
+        return true;
+    } else if constexpr (is_scan_output_v<S>) {
+        return scan_number(in, arg);
+    } else if constexpr (std::is_same_v<T, char>) {
+        return match_literal(in, arg);
+    } else {
+        static_assert(std::is_convertible_v<const T&, std::string_view>,
+                      "scan() arguments must be outputs, chars or strings");
+        return match_literal(in, std::string_view(arg));
+    }
+}
+
+template <typename Tuple, size_t... Is>
+bool scan_all(std::string_view& in, Tuple& args, std::index_sequence<Is...>) noexcept {
+    return (true && ... &&
+            scan_one<std::tuple_element_t<Is, Tuple>, std::tuple_element_t<Is + 1, Tuple>>(
+                in, std::get<Is>(args), std::get<Is + 1>(args)));
+}
+
+}  // namespace detail
+
+struct scan_result {
+    std::string_view rest;  // the input after the last argument that matched
+    bool ok;                // whether all arguments matched
+    explicit operator bool() const noexcept { return ok; }
+};
+
+// Parses `in` into the outputs among ss..., matching the literals among them (see above).
+template <typename... Ss>
+scan_result scan(std::string_view in, Ss&&... ss) noexcept {
+    detail::scan_end end;
+    auto args = std::forward_as_tuple(std::forward<Ss>(ss)..., end);
+    const bool ok = detail::scan_all(in, args, std::index_sequence_for<Ss...>{});
+    return {in, ok};
+}
+
+// A range over the fields of a string separated by a delimiter.  n delimiters give n + 1 fields,
+// so an empty string has one empty field.
+class split_view {
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        iterator() = default;
+        std::string_view operator*() const noexcept {
+            return std::string_view(first_, static_cast<size_t>(field_end_ - first_));
+        }
+        iterator& operator++() noexcept {
+            if (field_end_ == last_) {
+                first_ = field_end_ = last_ = nullptr;
+                done_ = true;
+            } else {
+                first_ = field_end_ + 1;
+                field_end_ = detail::find_char(first_, last_, delimiter_);
+            }
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) noexcept {
+            return a.done_ == b.done_ && a.first_ == b.first_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) noexcept { return !(a == b); }
+
+       private:
+        friend class split_view;
+        iterator(std::string_view s, char delimiter) noexcept
+            : first_(s.data()),
+              field_end_(detail::find_char(s.data(), s.data() + s.size(), delimiter)),
+              last_(s.data() + s.size()),
+              delimiter_(delimiter),
+              done_(false) {}
+
+        const char* first_ = nullptr;      // start of the current field
+        const char* field_end_ = nullptr;  // end of the current field
+        const char* last_ = nullptr;       // end of the string
+        char delimiter_ = 0;
+        bool done_ = true;
+    };
+
+    split_view(std::string_view s, char delimiter) noexcept : s_(s), delimiter_(delimiter) {}
+    iterator begin() const noexcept { return iterator(s_, delimiter_); }
+    iterator end() const noexcept { return iterator(); }
+
+   private:
+    std::string_view s_;
+    char delimiter_;
+};
+
+// Splits `s` at each occurrence of `delimiter`.
+inline split_view split(std::string_view s, char delimiter) noexcept {
+    return split_view(s, delimiter);
+}
+
+}  // namespace lazycat
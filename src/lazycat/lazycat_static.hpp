@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <lazycat/lazycat_core.hpp>
+#include <string_view>
+
+// This file contains cat_array() and static_cat(), which run cat() in constant evaluation and
+// return the result as a fixed_string.  Unlike std::string, a fixed_string can be stored in a
+// constexpr variable, so tables, metric names and queries can be built with no cost at startup:
+//
+//   constexpr auto metric = lazycat::static_cat<lazycat::fixed_string("http.status."), 404>();
+//   constexpr auto query =
+//       lazycat::cat_array([] { return lazycat::cat("SELECT * FROM t LIMIT ", limit); });
+//
+// The size of the result is computed by a first pass over the writers in the same evaluation.
+// Writers that use intrinsics or std::to_chars at run time (integers, floating point numbers)
+// switch to constexpr code in constant evaluation, with the same output.
+
+namespace lazycat {
+
+// A string of exactly N code units, followed by a null terminator.  It is a structural type, so it
+// can also be a template argument (see static_cat()).
+template <typename CharT, size_t N>
+struct fixed_string {
+    CharT chars[N + 1]{};
+
+    constexpr fixed_string() noexcept = default;
+    constexpr fixed_string(const CharT (&s)[N + 1]) noexcept {
+        for (size_t i = 0; i != N; ++i) chars[i] = s[i];
+    }
+
+    constexpr static size_t size() noexcept { return N; }
+    constexpr const CharT* data() const noexcept { return chars; }
+    constexpr const CharT* c_str() const noexcept { return chars; }
+    constexpr std::basic_string_view<CharT> view() const noexcept { return {chars, N}; }
+    constexpr operator std::basic_string_view<CharT>() const noexcept { return view(); }
+};
+
+template <typename CharT, size_t N>
+fixed_string(const CharT (&)[N]) -> fixed_string<CharT, N - 1>;
+
+// Evaluates the catter returned by f, which must be default-constructible (like a lambda without
+// captures), at compile time.  The character type is that of the catter.
+template <typename F>
+LAZYCAT_CONSTEVAL auto cat_array(F) noexcept {
+    using catter_type = decltype(F{}());
+    constexpr size_t sz = F{}().size();
+    fixed_string<typename catter_type::char_type, sz> ret;
+    catter_type c = F{}();
+    c.size();  // size() is always called before write(), and some writers depend on that
+    c.write(ret.chars);
+    return ret;
+}
+
+// cat(args...) at compile time.  Strings must be given as fixed_strings, since string literals
+// cannot be template arguments.
+template <auto... Args>
+LAZYCAT_CONSTEVAL auto static_cat() noexcept {
+    return cat_array([] { return cat(Args...); });
+}
+
+}  // namespace lazycat
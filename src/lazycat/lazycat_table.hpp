@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/lazycat_integral.hpp>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// This file contains format_table(), which formats the columns of a table (a struct of arrays)
+// into one string of delimited lines, e.g. CSV or TSV:
+//
+//   std::vector<std::int64_t> ids = ...;
+//   std::vector<double> prices = ...;
+//   std::vector<std::string_view> names = ...;
+//   std::string csv = lazycat::format_table({.separator = ','}, ids, prices, names);
+//
+// Instead of one cat() per row, the size pass runs column by column (over integer columns it is
+// a tight digit counting loop, and the digit counts are kept for the write pass), so that the
+// whole table is allocated once.  The rows are then written in order, so the output is written
+// sequentially.  Both passes can be split into row ranges on several threads; the sizes of the
+// ranges are prefix-summed into their offsets in the output.
+//
+// Columns are contiguous ranges (std::vector, std::array, std::span, ...) of anything cat()
+// accepts, and fields are written as cat() writes them, without quoting.  The number of rows is
+// that of the shortest column.
+
+namespace lazycat {
+
+struct table_format {
+    char separator = ',';
+    std::string_view line_end = "\n";
+    unsigned threads = 1;  // the maximum number of threads (each gets at least 4096 rows)
+};
+
+namespace detail {
+
+template <typename Column>
+using table_element_t = std::remove_cv_t<
+    std::remove_reference_t<decltype(*std::data(std::declval<const Column&>()))>>;
+
+// A column of integers (as accepted by integral_writer).  The digit counts (see digit_counts())
+// are kept from the size pass for the write pass.
+template <typename T>
+struct integral_table_column {
+    const T* data;
+    std::unique_ptr<std::uint8_t[]> widths;
+
+    integral_table_column(const T* d, size_t rows) : data(d), widths(new std::uint8_t[rows]) {}
+    size_t size(size_t first, size_t last) {
+        digit_counts(std::span<const T>(data + first, last - first), widths.get() + first);
+        size_t ret = 0;
+        for (size_t i = first; i != last; ++i) ret += widths[i];
+        return ret;
+    }
+    char* write(size_t i, char* out) const {
+        return write_integral_chars(out, data[i], widths[i]);
+    }
+};
+
+// A column of strings.
+template <typename T>
+struct string_table_column {
+    const T* data;
+
+    string_table_column(const T* d, size_t) : data(d) {}
+    size_t size(size_t first, size_t last) {
+        size_t ret = 0;
+        for (size_t i = first; i != last; ++i) ret += std::string_view(data[i]).size();
+        return ret;
+    }
+    char* write(size_t i, char* out) const {
+        const std::string_view s(data[i]);
+        return copy_chars(s.data(), s.size(), out);
+    }
+};
+
+// A column of anything else.  The writers are kept from the size pass, since they may cache state
+// between size() and write() (e.g. the formatted digits of floating point numbers).
+template <typename T>
+struct writer_table_column {
+    using writer_type = decltype(make_writer<char>(std::declval<const T&>()));
+    const T* data;
+    std::unique_ptr<writer_type[]> writers;
+
+    writer_table_column(const T* d, size_t rows) : data(d), writers(new writer_type[rows]) {}
+    size_t size(size_t first, size_t last) {
+        size_t ret = 0;
+        for (size_t i = first; i != last; ++i) {
+            writers[i] = make_writer<char>(data[i]);
+            ret += writers[i].size();
+        }
+        return ret;
+    }
+    char* write(size_t i, char* out) const { return writers[i].write(out); }
+};
+
+template <typename T, typename = void>
+constexpr bool is_integral_column_v = false;
+template <typename T>
+constexpr bool is_integral_column_v<T, std::enable_if_t<std::is_integral_v<T> &&
+                                                        !std::is_same_v<T, bool>>> =
+    std::is_same_v<T, std::make_signed_t<T>> || std::is_same_v<T, std::make_unsigned_t<T>>;
+
+template <typename T>
+using table_column_t = std::conditional_t<
+    is_integral_column_v<T>, integral_table_column<T>,
+    std::conditional_t<std::is_convertible_v<const T&, std::string_view>, string_table_column<T>,
+                       writer_table_column<T>>>;
+
+// Runs f(0), ..., f(count - 1), on count threads.
+template <typename F>
+void run_on_threads(unsigned count, const F& f) {
+    std::vector<std::thread> threads;
+    threads.reserve(count - 1);
+    for (unsigned i = 1; i < count; ++i) threads.emplace_back([&f, i] { f(i); });
+    f(0);
+    for (std::thread& t : threads) t.join();
+}
+
+}  // namespace detail
+
+// Formats the rows of the columns as lines of fields separated by format.separator, each followed
+// by format.line_end.
+template <typename... Columns>
+std::string format_table(const table_format& format, const Columns&... columns) {
+    static_assert(sizeof...(Columns) != 0, "format_table() needs at least one column");
+    constexpr size_t min_rows_per_thread = 4096;
+    const size_t rows = std::min({static_cast<size_t>(std::size(columns))...});
+    std::tuple<detail::table_column_t<detail::table_element_t<Columns>>...> table(
+        detail::table_column_t<detail::table_element_t<Columns>>(std::data(columns), rows)...);
+    const unsigned ranges = static_cast<unsigned>(
+        std::clamp<size_t>(rows / min_rows_per_thread, 1, std::max(format.threads, 1u)));
+    const auto range_first = [&](unsigned r) { return rows * r / ranges; };
+
+    // Size pass, column by column: the size of each range of rows
+    std::vector<size_t> range_offsets(ranges + 1);
+    detail::run_on_threads(ranges, [&](unsigned r) {
+        const size_t first = range_first(r), last = range_first(r + 1);
+        range_offsets[r + 1] = std::apply(
+            [&](auto&... column) {
+                return (last - first) * (sizeof...(Columns) - 1 + format.line_end.size()) +
+                       (column.size(first, last) + ...);
+            },
+            table);
+    });
+    for (unsigned r = 0; r != ranges; ++r) range_offsets[r + 1] += range_offsets[r];
+    std::string ret = detail::construct_default_init<char>(range_offsets[ranges]);
+
+    // Write pass, row by row
+    detail::run_on_threads(ranges, [&](unsigned r) {
+        char* out = ret.data() + range_offsets[r];
+        for (size_t i = range_first(r), last = range_first(r + 1); i != last; ++i) {
+            std::apply(
+                [&](const auto& head, const auto&... tail) {
+                    out = head.write(i, out);
+                    ((*out++ = format.separator, out = tail.write(i, out)), ...);
+                },
+                table);
+            if (format.line_end.size() == 1) {
+                *out++ = format.line_end[0];
+            } else {
+                out = detail::copy_chars(format.line_end.data(), format.line_end.size(), out);
+            }
+        }
+    });
+    return ret;
+}
+
+}  // namespace lazycat
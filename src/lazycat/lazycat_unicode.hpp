@@ -0,0 +1,281 @@
+#pragma once
+
+#include <bit>
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/util.hpp>
+#include <string_view>
+
+// This file contains writers that transcode UTF-16 and UTF-32 into UTF-8, and a writer that
+// validates UTF-8.  Invalid input (lone surrogates, out of range code points, malformed UTF-8) is
+// replaced with U+FFFD.  All of them write UTF-8, so they can only be used with one-byte output
+// character types (char and char8_t).  With SSE2, the transcoders measure 8 UTF-16 or 4 UTF-32 code
+// units at a time and convert blocks of ASCII at once.  Validation is not vectorized: SSE2 only
+// skips blocks of 16 ASCII bytes, and every other sequence is checked with scalar code.
+
+namespace lazycat {
+
+namespace detail {
+
+// Number of UTF-8 code units needed to encode cp (which must be a valid code point).
+constexpr size_t utf8_encoded_length(char32_t cp) noexcept {
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+template <typename CharT>
+constexpr CharT* utf8_encode(char32_t cp, CharT* out) noexcept {
+    static_assert(sizeof(CharT) == 1, "UTF-8 can only be written into one-byte characters");
+    if (cp < 0x80) {
+        *out++ = static_cast<CharT>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<CharT>(0xC0 | (cp >> 6));
+        *out++ = static_cast<CharT>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<CharT>(0xE0 | (cp >> 12));
+        *out++ = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<CharT>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<CharT>(0xF0 | (cp >> 18));
+        *out++ = static_cast<CharT>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<CharT>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// Decodes one code point from in[i], advancing i.  Lone surrogates decode to U+FFFD.
+constexpr char32_t utf16_decode(const char16_t* in, size_t count, size_t& i) noexcept {
+    const char32_t c = in[i++];
+    if ((c & 0xF800) != 0xD800) return c;
+    if ((c & 0xFC00) == 0xD800 && i != count && (in[i] & 0xFC00) == 0xDC00) {
+        return 0x10000 + ((c - 0xD800) << 10) + (in[i++] - 0xDC00);
+    }
+    return replacement_character;
+}
+
+constexpr char32_t utf32_sanitize(char32_t c) noexcept {
+    return (c > 0x10FFFF || (c & 0xFFFFF800) == 0xD800) ? replacement_character : c;
+}
+
+// Exact UTF-8 length of a UTF-16 string.
+inline size_t utf8_length_from_utf16(const char16_t* in, size_t count) noexcept {
+    size_t sz = 0;
+    size_t i = 0;
+#if defined(LAZYCAT_HAS_SSE2)
+    // Each code unit contributes 1 byte, plus 1 if >= 0x80, plus 1 if >= 0x800.  Blocks with
+    // surrogates are left to the scalar loop.  The xor maps unsigned order onto signed order.
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128i lim_80 = _mm_set1_epi16(static_cast<short>(0x007F ^ 0x8000));
+    const __m128i lim_800 = _mm_set1_epi16(static_cast<short>(0x07FF ^ 0x8000));
+    const __m128i surrogate_mask = _mm_set1_epi16(static_cast<short>(0xF800));
+    const __m128i surrogate_tag = _mm_set1_epi16(static_cast<short>(0xD800));
+    while (i + 8 <= count) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(v, surrogate_mask), surrogate_tag);
+        if (_mm_movemask_epi8(surrogates) != 0) {
+            const size_t block_end = i + 8;
+            while (i < block_end) {
+                sz += utf8_encoded_length(utf16_decode(in, count, i));
+            }
+            continue;
+        }
+        const __m128i biased = _mm_xor_si128(v, bias);
+        const unsigned ge_80 =
+            static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(biased, lim_80)));
+        const unsigned ge_800 =
+            static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(biased, lim_800)));
+        sz += 8 + (std::popcount(ge_80) + std::popcount(ge_800)) / 2;
+        i += 8;
+    }
+#endif
+    while (i < count) sz += utf8_encoded_length(utf16_decode(in, count, i));
+    return sz;
+}
+
+// Exact UTF-8 length of a UTF-32 string.
+inline size_t utf8_length_from_utf32(const char32_t* in, size_t count) noexcept {
+    size_t sz = 0;
+    size_t i = 0;
+#if defined(LAZYCAT_HAS_SSE2)
+    // Blocks with invalid code points (which could also break the signed comparisons) are left to
+    // the scalar loop.
+    const __m128i lim_80 = _mm_set1_epi32(0x7F);
+    const __m128i lim_800 = _mm_set1_epi32(0x7FF);
+    const __m128i lim_10000 = _mm_set1_epi32(0xFFFF);
+    const __m128i lim_max = _mm_set1_epi32(0x10FFFF);
+    const __m128i surrogate_mask = _mm_set1_epi32(static_cast<int>(0xFFFFF800));
+    const __m128i surrogate_tag = _mm_set1_epi32(0xD800);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i invalid = _mm_or_si128(
+            _mm_or_si128(_mm_cmpgt_epi32(v, lim_max), _mm_cmplt_epi32(v, _mm_setzero_si128())),
+            _mm_cmpeq_epi32(_mm_and_si128(v, surrogate_mask), surrogate_tag));
+        if (_mm_movemask_epi8(invalid) != 0) {
+            for (size_t j = i; j != i + 4; ++j) sz += utf8_encoded_length(utf32_sanitize(in[j]));
+            continue;
+        }
+        const auto count_lanes = [](__m128i mask) {
+            return static_cast<size_t>(
+                std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(mask)))));
+        };
+        sz += 4 + count_lanes(_mm_cmpgt_epi32(v, lim_80)) +
+              count_lanes(_mm_cmpgt_epi32(v, lim_800)) +
+              count_lanes(_mm_cmpgt_epi32(v, lim_10000));
+    }
+#endif
+    for (; i != count; ++i) sz += utf8_encoded_length(utf32_sanitize(in[i]));
+    return sz;
+}
+
+template <typename CharT>
+inline CharT* utf8_from_utf16(const char16_t* in, size_t count, CharT* out) noexcept {
+    size_t i = 0;
+    while (i < count) {
+#if defined(LAZYCAT_HAS_SSE2)
+        // ASCII fast path: narrow 8 code units at a time
+        if (i + 8 <= count) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            if (_mm_movemask_epi8(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80)))) ==
+                0) {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, v));
+                out += 8;
+                i += 8;
+                continue;
+            }
+        }
+#endif
+        out = utf8_encode(utf16_decode(in, count, i), out);
+    }
+    return out;
+}
+
+template <typename CharT>
+inline CharT* utf8_from_utf32(const char32_t* in, size_t count, CharT* out) noexcept {
+    size_t i = 0;
+    while (i < count) {
+#if defined(LAZYCAT_HAS_SSE2)
+        // ASCII fast path: narrow 4 code units at a time
+        if (i + 4 <= count) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i high_bits =
+                _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(high_bits, _mm_setzero_si128())) == 0xFFFF) {
+                const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+                const int bytes = _mm_cvtsi128_si32(packed);
+                std::memcpy(out, &bytes, 4);
+                out += 4;
+                i += 4;
+                continue;
+            }
+        }
+#endif
+        out = utf8_encode(utf32_sanitize(in[i++]), out);
+    }
+    return out;
+}
+
+}  // namespace detail
+
+struct utf8_from_utf16_writer : public base_writer {
+    std::u16string_view content;
+    size_t size() const noexcept {
+        return detail::utf8_length_from_utf16(content.data(), content.size());
+    }
+    template <typename CharT>
+    CharT* write(CharT* out) const noexcept {
+        static_assert(sizeof(CharT) == 1, "UTF-8 can only be written into one-byte characters");
+        return detail::utf8_from_utf16(content.data(), content.size(), out);
+    }
+};
+
+struct utf8_from_utf32_writer : public base_writer {
+    std::u32string_view content;
+    size_t size() const noexcept {
+        return detail::utf8_length_from_utf32(content.data(), content.size());
+    }
+    template <typename CharT>
+    CharT* write(CharT* out) const noexcept {
+        static_assert(sizeof(CharT) == 1, "UTF-8 can only be written into one-byte characters");
+        return detail::utf8_from_utf32(content.data(), content.size(), out);
+    }
+};
+
+// Writes UTF-8 input, replacing each maximal invalid subpart with U+FFFD.  size() validates the
+// input (skipping ASCII runs with SSE2, and decoding everything else one sequence at a time), and
+// if it is valid, write() just copies it.
+struct validated_utf8_writer : public base_writer {
+    std::string_view content;
+    mutable bool cached_valid;  // whether content is entirely valid
+    size_t size() const noexcept {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(content.data());
+        const unsigned char* const end = in + content.size();
+        size_t sz = 0;
+        bool valid = true;
+        while (in != end) {
+#if defined(LAZYCAT_HAS_SSE2)
+            // ASCII fast path
+            if (end - in >= 16 &&
+                _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))) == 0) {
+                in += 16;
+                sz += 16;
+                continue;
+            }
+#endif
+            size_t invalid_len;
+            const size_t len = detail::utf8_sequence_length(in, end, invalid_len);
+            if (len != 0) {
+                in += len;
+                sz += len;
+            } else {
+                in += invalid_len;
+                sz += 3;  // U+FFFD
+                valid = false;
+            }
+        }
+        cached_valid = valid;
+        return sz;
+    }
+    template <typename CharT>
+    CharT* write(CharT* out) const noexcept {
+        static_assert(sizeof(CharT) == 1, "UTF-8 can only be written into one-byte characters");
+        if (cached_valid) return detail::copy_chars(content.data(), content.size(), out);
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(content.data());
+        const unsigned char* const end = in + content.size();
+        while (in != end) {
+            size_t invalid_len;
+            const size_t len = detail::utf8_sequence_length(in, end, invalid_len);
+            if (len != 0) {
+                out = detail::copy_chars(in, len, out);
+                in += len;
+            } else {
+                out = detail::utf8_encode(detail::replacement_character, out);
+                in += invalid_len;
+            }
+        }
+        return out;
+    }
+};
+
+[[nodiscard]] constexpr utf8_from_utf16_writer utf8_from(std::u16string_view content) noexcept {
+    return utf8_from_utf16_writer{{}, content};
+}
+
+[[nodiscard]] constexpr utf8_from_utf32_writer utf8_from(std::u32string_view content) noexcept {
+    return utf8_from_utf32_writer{{}, content};
+}
+
+// wchar_t is UTF-16 on Windows and UTF-32 elsewhere.
+[[nodiscard]] inline auto utf8_from(std::wstring_view content) noexcept {
+    if constexpr (sizeof(wchar_t) == sizeof(char16_t)) {
+        return utf8_from(std::u16string_view(reinterpret_cast<const char16_t*>(content.data()),
+                                             content.size()));
+    } else {
+        return utf8_from(std::u32string_view(reinterpret_cast<const char32_t*>(content.data()),
+                                             content.size()));
+    }
+}
+
+[[nodiscard]] constexpr validated_utf8_writer validated_utf8(std::string_view content) noexcept {
+    return validated_utf8_writer{{}, content, true};
+}
+
+}  // namespace lazycat
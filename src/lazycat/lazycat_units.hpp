@@ -0,0 +1,294 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#if !(defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L)
+#include <cstdio>
+#endif
+#include <lazycat/lazycat_core.hpp>
+#include <lazycat/lazycat_floating_point.hpp>
+#include <lazycat/lazycat_integral.hpp>
+#include <lazycat/util.hpp>
+#include <limits>
+#include <type_traits>
+
+// This file contains locale-independent writers for human-readable numbers:
+//   grouped(x, sep)           integer with digit grouping, e.g. "1,234,567"
+//   bytes_iec(x)              byte count with IEC units, e.g. "512 B", "12.3 MiB"
+//   si_units(x, precision)    SI prefixes, e.g. "4.2k", "12.50M", "3.0m"
+// All of them compute their exact size in size() and write in one pass, and all of them can be
+// constant evaluated (see lazycat_static.hpp).
+
+namespace lazycat {
+
+namespace detail {
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+// prevents C4146: unary minus operator applied to unsigned type, result still unsigned
+#pragma warning(disable : 4146)
+#endif
+
+template <typename T>
+constexpr bool is_negative(const T& val) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+        return val < static_cast<T>(0);
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+constexpr std::make_unsigned_t<T> unsigned_magnitude(const T& val) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+        return val < static_cast<T>(0) ? -static_cast<std::make_unsigned_t<T>>(val)
+                                       : static_cast<std::make_unsigned_t<T>>(val);
+    } else {
+        return val;
+    }
+}
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+// Writes `digits` digits of val, with a separator before every group of three (from the right).
+template <typename CharT, typename T>
+constexpr CharT* write_grouped_digits(CharT* out, T val, size_t digits, char separator) noexcept {
+    CharT* const end = out + digits + (digits - 1) / 3;
+    CharT* it = end;
+    for (unsigned in_group = 0;; ++in_group) {
+        if (in_group == 3) {
+            *--it = static_cast<CharT>(separator);
+            in_group = 0;
+        }
+        *--it = static_cast<CharT>('0' + static_cast<char>(val % static_cast<T>(10)));
+        val /= static_cast<T>(10);
+        if (val == static_cast<T>(0)) break;
+    }
+    return end;
+}
+
+// Formats val with a fixed number of digits after the decimal point.  Returns the end of the
+// output.  The buffer must be large enough.
+constexpr char* format_fixed(char* first, char* last, double val, int precision) noexcept {
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+    if (std::is_constant_evaluated()) return constexpr_to_chars_fixed(first, val, precision);
+#endif
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    return std::to_chars(first, last, val, std::chars_format::fixed, precision).ptr;
+#else
+    return first + std::snprintf(first, last - first, "%.*f", precision, val);
+#endif
+}
+
+// Formats val in its shortest form.  The buffer must be large enough.
+constexpr char* format_shortest(char* first, char* last, double val) noexcept {
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+    if (std::is_constant_evaluated()) return constexpr_to_chars(first, val);
+#endif
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    return std::to_chars(first, last, val).ptr;
+#else
+    return first + std::snprintf(first, last - first, "%g", val);
+#endif
+}
+
+}  // namespace detail
+
+template <typename T>
+struct grouped_writer : public base_writer {
+    T content;
+    char separator;
+    mutable size_t cached_digits;  // number of digits, excluding the sign and separators
+    constexpr size_t size() const noexcept {
+        const size_t digits = uncached_digits();
+        cached_digits = digits;
+        return detail::is_negative(content) + digits + (digits - 1) / 3;
+    }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+        if (detail::is_negative(content)) *out++ = static_cast<CharT>('-');
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+        // Some compilers (e.g. GCC 12) do not allow reading mutable members in constant evaluation
+        if (std::is_constant_evaluated()) {
+            return detail::write_grouped_digits(out, detail::unsigned_magnitude(content),
+                                                uncached_digits(), separator);
+        }
+#endif
+        return detail::write_grouped_digits(out, detail::unsigned_magnitude(content), cached_digits,
+                                            separator);
+    }
+    constexpr size_t uncached_digits() const noexcept {
+        return detail::calculate_integral_size_unsigned<
+            std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1>(
+            detail::unsigned_magnitude(content));
+    }
+};
+
+// Byte counts below 1024 are written as "N B"; otherwise the largest unit that keeps the value at
+// least 1 is used, with one digit after the decimal point ("1.5 KiB").  A value that rounds up to
+// 1024.0 moves to the next unit.
+struct bytes_iec_writer : public base_writer {
+    std::uint64_t content;
+    mutable unsigned cached_unit;          // 0 = B, 1 = KiB, 2 = MiB, ...
+    mutable std::uint64_t cached_tenths;   // value in tenths of the unit (unused for B)
+    mutable size_t cached_integer_digits;  // digits before the decimal point
+    constexpr static char unit_letters[] = " KMGTPE";
+
+    constexpr size_t size() const noexcept {
+        unsigned unit = 0;
+        std::uint64_t tenths = 0;
+        const size_t integer_digits = layout(unit, tenths);
+        cached_unit = unit;
+        cached_tenths = tenths;
+        cached_integer_digits = integer_digits;
+        return integer_digits + (content < 1024 ? 2 : 6);  // " B" or ".d XiB"
+    }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+        // Some compilers (e.g. GCC 12) do not allow reading mutable members in constant evaluation
+        if (std::is_constant_evaluated()) {
+            unsigned unit = 0;
+            std::uint64_t tenths = 0;
+            const size_t integer_digits = layout(unit, tenths);
+            return write_parts(out, unit, tenths, integer_digits);
+        }
+#endif
+        return write_parts(out, cached_unit, cached_tenths, cached_integer_digits);
+    }
+
+   private:
+    // Picks the unit and the value in tenths of it, returning the number of integer digits
+    constexpr size_t layout(unsigned& unit, std::uint64_t& tenths) const noexcept {
+        if (content < 1024) {
+            unit = 0;
+            return detail::calculate_integral_size_unsigned<20>(content);
+        }
+        unit = static_cast<unsigned>(std::bit_width(content) - 1) / 10;
+        tenths = round_tenths(unit);
+        if (tenths >= 10240 && unit < 6) tenths = round_tenths(++unit);
+        return detail::calculate_integral_size_unsigned<20>(tenths / 10);
+    }
+    template <typename CharT>
+    constexpr CharT* write_parts(CharT* out,
+                                 unsigned unit,
+                                 std::uint64_t tenths,
+                                 size_t integer_digits) const noexcept {
+        if (unit == 0) {
+            out += integer_digits;
+            detail::write_integral_chars_unsigned(out, content);
+            *out++ = static_cast<CharT>(' ');
+            *out++ = static_cast<CharT>('B');
+            return out;
+        }
+        out += integer_digits;
+        detail::write_integral_chars_unsigned(out, tenths / 10);
+        *out++ = static_cast<CharT>('.');
+        *out++ = static_cast<CharT>('0' + tenths % 10);
+        *out++ = static_cast<CharT>(' ');
+        *out++ = static_cast<CharT>(unit_letters[unit]);
+        *out++ = static_cast<CharT>('i');
+        *out++ = static_cast<CharT>('B');
+        return out;
+    }
+    // content / 1024^unit in tenths, rounded half up, without overflowing
+    constexpr std::uint64_t round_tenths(unsigned unit) const noexcept {
+        const unsigned shift = unit * 10;
+        const std::uint64_t quotient = content >> shift;
+        const std::uint64_t remainder = content & ((std::uint64_t{1} << shift) - 1);
+        return quotient * 10 + ((remainder * 10 + (std::uint64_t{1} << (shift - 1))) >> shift);
+    }
+};
+
+// Writes x scaled to an SI prefix (y z a f p n u m k M G T P E Z Y, with 'u' for micro) with
+// `precision` digits after the decimal point, so that the integer part has 1 to 3 digits.  Zero,
+// infinities and NaN are written without a prefix, and values beyond the range of the prefixes are
+// written in their shortest form (like floating_point_writer).  Precision is clamped to [0, 15].
+struct si_units_writer : public base_writer {
+    double content;
+    int precision;
+    constexpr static size_t buffer_size = 48;
+    mutable char cached_buffer[buffer_size];
+    mutable size_t cached_size;
+
+    constexpr static int max_exp3 = 8;  // the largest prefix, Y (1e24)
+    constexpr static double powers_of_1000[] = {1e-24, 1e-21, 1e-18, 1e-15, 1e-12, 1e-9,
+                                                1e-6,  1e-3,  1e0,   1e3,   1e6,   1e9,
+                                                1e12,  1e15,  1e18,  1e21,  1e24};
+
+    constexpr size_t size() const noexcept {
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+        if (std::is_constant_evaluated()) {
+            char buffer[buffer_size]{};
+            return cached_size = format(buffer);
+        }
+#endif
+        return cached_size = format(cached_buffer);
+    }
+    template <typename CharT>
+    constexpr CharT* write(CharT* out) const noexcept {
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+        // Some compilers (e.g. GCC 12) do not allow reading mutable members in constant
+        // evaluation, so the number is formatted again
+        if (std::is_constant_evaluated()) {
+            char buffer[buffer_size]{};
+            return detail::copy_chars(buffer, format(buffer), out);
+        }
+#endif
+        return detail::copy_chars(cached_buffer, cached_size, out);
+    }
+
+   private:
+    // Formats into buffer (of buffer_size chars), returning the length
+    constexpr size_t format(char* buffer) const noexcept {
+        constexpr char prefixes[] = "yzafpnum kMGTPEZY";
+        const int digits = precision < 0 ? 0 : precision > 15 ? 15 : precision;
+        char* const last = buffer + buffer_size - 1;  // room for the prefix
+        const double magnitude = content < 0 ? -content : content;
+        if (content == 0 || !(magnitude <= std::numeric_limits<double>::max())) {
+            return detail::format_fixed(buffer, last, content, digits) - buffer;
+        }
+        if (magnitude < powers_of_1000[0] || magnitude >= 1e27) {
+            return detail::format_shortest(buffer, last, content) - buffer;
+        }
+        int exp3 = -max_exp3;
+        while (exp3 < max_exp3 && magnitude >= powers_of_1000[exp3 + max_exp3 + 1]) ++exp3;
+        char* end = format_scaled(buffer, exp3, digits, last);
+        if (exp3 < max_exp3 && integer_digits(buffer, end) > 3) {
+            end = format_scaled(buffer, ++exp3, digits, last);  // rounded up to 1000
+        }
+        if (exp3 != 0) *end++ = prefixes[exp3 + max_exp3];
+        return end - buffer;
+    }
+    constexpr char* format_scaled(char* buffer, int exp3, int digits, char* last) const noexcept {
+        const double scaled = content / powers_of_1000[exp3 + max_exp3];
+        return detail::format_fixed(buffer, last, scaled, digits);
+    }
+    constexpr static size_t integer_digits(const char* buffer, const char* end) noexcept {
+        const char* it = buffer + (buffer[0] == '-');
+        const char* const begin = it;
+        while (it != end && *it != '.') ++it;
+        return it - begin;
+    }
+};
+
+template <typename T,
+          typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+[[nodiscard]] constexpr grouped_writer<T> grouped(T x, char separator = ',') noexcept {
+    return grouped_writer<T>{{}, x, separator, 0};
+}
+
+[[nodiscard]] constexpr bytes_iec_writer bytes_iec(std::uint64_t x) noexcept {
+    return bytes_iec_writer{{}, x, 0, 0, 0};
+}
+
+[[nodiscard]] constexpr si_units_writer si_units(double x, int precision = 1) noexcept {
+    return si_units_writer{{}, x, precision, {}, 0};
+}
+
+}  // namespace lazycat
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <lazycat/instrumentation.hpp>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -43,6 +47,31 @@
 #define LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC
 #endif
 
+// expands to 'consteval' if available, and to 'constexpr' otherwise
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define LAZYCAT_CONSTEVAL consteval
+#else
+#define LAZYCAT_CONSTEVAL constexpr
+#endif
+
+// SSE2 intrinsics (used for widening narrow chars)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LAZYCAT_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// SSE4.2 intrinsics (used for CRC-32C), only when the compiler targets SSE4.2
+#if defined(__SSE4_2__) || defined(__AVX__)
+#define LAZYCAT_HAS_SSE42
+#include <nmmintrin.h>
+#endif
+
+// AVX2 intrinsics (used for searching delimiters), only when the compiler targets AVX2
+#if defined(__AVX2__)
+#define LAZYCAT_HAS_AVX2
+#include <immintrin.h>
+#endif
+
 namespace lazycat {
 namespace detail {
 // helper void_t
@@ -58,8 +87,12 @@ using void_t = typename make_void<Ts...>::type;
 #endif
 
 #ifdef LAZYCAT_DANGEROUS_OPTIMIZATIONS
-// A char_trait for char that where all chars (except EOF) are equal to one another.
-struct noop_char_traits : public std::char_traits<char> {
+// A char_trait for CharT where all chars (except EOF) are equal to one another.
+template <typename CharT>
+struct noop_char_traits : public std::char_traits<CharT> {
+    using typename std::char_traits<CharT>::char_type;
+    using typename std::char_traits<CharT>::int_type;
+    using std::char_traits<CharT>::eof;
     static constexpr void assign(char_type&, const char_type&) noexcept {}
     static constexpr char_type* assign(char_type* p, std::size_t, char_type) noexcept { return p; }
     static constexpr bool eq(char_type, char_type) noexcept { return true; }
@@ -84,6 +117,11 @@ struct noop_char_traits : public std::char_traits<char> {
     // static constexpr int_type eof() noexcept; // same as base
     static constexpr int_type not_eof(int_type e) noexcept { return e != eof() ? e : 0; }
 };
+
+// The string type with the same chars as S, whose resizes do not write the new chars
+template <typename S>
+using noop_string_t =
+    std::basic_string<typename S::value_type, noop_char_traits<typename S::value_type>>;
 #endif
 
 // Like s.resize(sz) but without writing to the new chars.
@@ -96,11 +134,11 @@ struct construct_default_init_t {
         if (std::is_constant_evaluated()) {
             return S(sz, typename S::value_type{});
         } else {
-            std::basic_string<char, noop_char_traits> ret(sz, typename S::value_type{});
+            noop_string_t<S> ret(sz, typename S::value_type{});
             return reinterpret_cast<S&&>(std::move(ret));  // this is UB but works
         }
 #else
-        std::basic_string<char, noop_char_traits> ret(sz, typename S::value_type{});
+        noop_string_t<S> ret(sz, typename S::value_type{});
         return reinterpret_cast<S&&>(std::move(ret));  // this is UB but works
 #endif
 #else
@@ -120,21 +158,23 @@ struct construct_default_init_t<
 };
 template <typename S, typename = void>
 struct append_default_init_t {
-    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC static char* append_default_init(S& s, size_t sz) {
+    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC static typename S::value_type* append_default_init(
+        S& s,
+        size_t sz) {
         const size_t old_sz = s.size();
         LAZYCAT_ASSUME(old_sz <= old_sz + sz);
 #ifdef LAZYCAT_DANGEROUS_OPTIMIZATIONS
 #if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
         if (std::is_constant_evaluated()) {
-            s.append(sz, char{});
+            s.append(sz, typename S::value_type{});
         } else {
-            reinterpret_cast<std::basic_string<char, noop_char_traits>&>(s).append(sz, char{});
+            reinterpret_cast<noop_string_t<S>&>(s).append(sz, typename S::value_type{});
         }
 #else
-        reinterpret_cast<std::basic_string<char, noop_char_traits>&>(s).append(sz, char{});
+        reinterpret_cast<noop_string_t<S>&>(s).append(sz, typename S::value_type{});
 #endif
 #else
-        s.append(sz, char{});
+        s.append(sz, typename S::value_type{});
 #endif
         return s.data() + old_sz;
     }
@@ -143,7 +183,9 @@ template <typename S>
 struct append_default_init_t<
     S,
     void_t<decltype(std::declval<S&>().__append_default_init(std::declval<size_t>()))>> {
-    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC static char* append_default_init(S& s, size_t sz) {
+    LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC static typename S::value_type* append_default_init(
+        S& s,
+        size_t sz) {
         const size_t old_sz = s.size();
         LAZYCAT_ASSUME(old_sz <= old_sz + sz);
         s.__append_default_init(sz);
@@ -151,12 +193,218 @@ struct append_default_init_t<
     }
 };
 
-LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC inline std::string construct_default_init(size_t sz) {
-    return construct_default_init_t<std::string>::construct_default_init(sz);
+template <typename CharT = char>
+LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC inline std::basic_string<CharT> construct_default_init(
+    size_t sz) {
+#ifdef LAZYCAT_INSTRUMENTATION
+    std::basic_string<CharT> ret =
+        construct_default_init_t<std::basic_string<CharT>>::construct_default_init(sz);
+    record_materialization(ret);
+    return ret;
+#else
+    return construct_default_init_t<std::basic_string<CharT>>::construct_default_init(sz);
+#endif
+}
+
+template <typename CharT>
+LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC inline CharT* append_default_init(std::basic_string<CharT>& s,
+                                                                     size_t sz) {
+#ifdef LAZYCAT_INSTRUMENTATION
+    const size_t old_capacity = s.capacity();
+    CharT* const out = append_default_init_t<std::basic_string<CharT>>::append_default_init(s, sz);
+    record_append(s, old_capacity);
+    return out;
+#else
+    return append_default_init_t<std::basic_string<CharT>>::append_default_init(s, sz);
+#endif
+}
+
+constexpr char32_t replacement_character = 0xFFFD;
+
+// Converts a narrow code unit to a wider OutCharT.  Narrow text is UTF-8, and a single non-ASCII
+// code unit cannot be decoded on its own, so it becomes U+FFFD.
+template <typename OutCharT, typename InCharT>
+constexpr OutCharT widen_char(InCharT c) noexcept {
+    static_assert(sizeof(InCharT) == 1 && sizeof(OutCharT) > 1);
+    const unsigned char u = static_cast<unsigned char>(c);
+    return static_cast<OutCharT>(u < 0x80 ? char32_t{u} : replacement_character);
+}
+
+// Copies `count` code units from `in` to `out`, converting each code unit from InCharT to OutCharT
+// with widen_char.  The output has as many code units as the input, so ASCII is widened as is and
+// every other code unit becomes U+FFFD.  Writers that take narrow strings from the user decode
+// them as UTF-8 instead (see basic_utf8_decoding_writer).  Narrowing is not supported.
+template <typename InCharT, typename OutCharT>
+inline LAZYCAT_FORCEINLINE void widen_chars(const InCharT* in,
+                                            size_t count,
+                                            OutCharT* out) noexcept {
+    static_assert(sizeof(InCharT) == 1 && sizeof(OutCharT) > 1);
+#if defined(LAZYCAT_HAS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; count >= 16; count -= 16, in += 16, out += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            for (size_t i = 0; i != 16; ++i) out[i] = widen_char<OutCharT>(in[i]);
+            continue;
+        }
+        const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        if constexpr (sizeof(OutCharT) == 2) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), hi);
+        } else {
+            static_assert(sizeof(OutCharT) == 4);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+#endif
+    for (size_t i = 0; i != count; ++i) out[i] = widen_char<OutCharT>(in[i]);
+}
+
+// Copies `count` code units from `in` to `out`, returning the end of the output.  Same-width code
+// units are copied verbatim; narrow code units are widened (see widen_chars).
+template <typename InCharT, typename OutCharT>
+constexpr OutCharT* copy_chars(const InCharT* in, size_t count, OutCharT* out) noexcept {
+    static_assert(sizeof(InCharT) == sizeof(OutCharT) || sizeof(InCharT) == 1,
+                  "Only same-width copies and widening of narrow chars are supported");
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_lib_is_constant_evaluated >= 201811
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i != count; ++i) {
+            if constexpr (sizeof(InCharT) == sizeof(OutCharT)) {
+                out[i] = static_cast<OutCharT>(in[i]);
+            } else {
+                out[i] = widen_char<OutCharT>(in[i]);
+            }
+        }
+        return out + count;
+    }
+#endif
+    if constexpr (sizeof(InCharT) == sizeof(OutCharT)) {
+        std::memcpy(out, in, count * sizeof(OutCharT));
+    } else {
+        widen_chars(in, count, out);
+    }
+    return out + count;
+}
+
+// Returns the length of the valid UTF-8 sequence starting at `in`, or 0 if it is invalid, in which
+// case `invalid_len` is set to the length of its maximal subpart (which is replaced by a single
+// U+FFFD, as recommended by the Unicode standard).
+template <typename InCharT>
+constexpr size_t utf8_sequence_length(const InCharT* in,
+                                      const InCharT* end,
+                                      size_t& invalid_len) noexcept {
+    static_assert(sizeof(InCharT) == 1);
+    const auto byte = [in](size_t i) { return static_cast<unsigned char>(in[i]); };
+    const unsigned char b0 = byte(0);
+    if (b0 < 0x80) return 1;
+    size_t len;
+    unsigned char lo = 0x80, hi = 0xBF;  // valid range of the second byte
+    if (b0 >= 0xC2 && b0 <= 0xDF) {
+        len = 2;
+    } else if (b0 >= 0xE0 && b0 <= 0xEF) {
+        len = 3;
+        if (b0 == 0xE0) lo = 0xA0;  // overlong
+        if (b0 == 0xED) hi = 0x9F;  // surrogates
+    } else if (b0 >= 0xF0 && b0 <= 0xF4) {
+        len = 4;
+        if (b0 == 0xF0) lo = 0x90;  // overlong
+        if (b0 == 0xF4) hi = 0x8F;  // above U+10FFFF
+    } else {
+        invalid_len = 1;
+        return 0;
+    }
+    if (end - in < 2 || byte(1) < lo || byte(1) > hi) {
+        invalid_len = 1;
+        return 0;
+    }
+    for (size_t i = 2; i != len; ++i) {
+        if (static_cast<size_t>(end - in) == i || (byte(i) & 0xC0) != 0x80) {
+            invalid_len = i;
+            return 0;
+        }
+    }
+    return len;
+}
+
+// Decodes the valid UTF-8 sequence of `len` code units at `in`.
+template <typename InCharT>
+constexpr char32_t utf8_decode(const InCharT* in, size_t len) noexcept {
+    constexpr unsigned char lead_mask[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+    char32_t cp = static_cast<unsigned char>(in[0]) & lead_mask[len];
+    for (size_t i = 1; i != len; ++i) cp = (cp << 6) | (static_cast<unsigned char>(in[i]) & 0x3F);
+    return cp;
+}
+
+// Number of leading ASCII code units of [in, in + count).
+template <typename InCharT>
+constexpr size_t ascii_prefix_length(const InCharT* in, size_t count) noexcept {
+    size_t i = 0;
+#if defined(LAZYCAT_HAS_SSE2) && defined(__cpp_lib_is_constant_evaluated) && \
+    __cpp_lib_is_constant_evaluated >= 201811
+    if (!std::is_constant_evaluated()) {
+        for (; i + 16 <= count; i += 16) {
+            const unsigned mask = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+            if (mask != 0) return i + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    while (i != count && static_cast<unsigned char>(in[i]) < 0x80) ++i;
+    return i;
+}
+
+// Exact length of UTF-8 input decoded into UTF-16 (two-byte OutCharT) or UTF-32 (four-byte
+// OutCharT).  Each maximal invalid subpart is replaced with one U+FFFD.
+template <typename OutCharT, typename InCharT>
+constexpr size_t utf8_decoded_length(const InCharT* in, size_t count) noexcept {
+    static_assert(sizeof(OutCharT) == 2 || sizeof(OutCharT) == 4);
+    const InCharT* const end = in + count;
+    size_t sz = 0;
+    while (in != end) {
+        const size_t ascii = ascii_prefix_length(in, static_cast<size_t>(end - in));
+        in += ascii;
+        sz += ascii;
+        if (in == end) break;
+        size_t invalid_len;
+        const size_t len = utf8_sequence_length(in, end, invalid_len);
+        in += len != 0 ? len : invalid_len;
+        sz += (sizeof(OutCharT) == 2 && len == 4) ? 2 : 1;  // a surrogate pair above U+FFFF
+    }
+    return sz;
 }
 
-LAZYCAT_CONSTEXPR_STRING_UTIL_MAGIC inline char* append_default_init(std::string& s, size_t sz) {
-    return append_default_init_t<std::string>::append_default_init(s, sz);
+// Decodes UTF-8 input into UTF-16 or UTF-32 (see utf8_decoded_length), returning the end of the
+// output.  ASCII runs are widened with copy_chars.
+template <typename InCharT, typename OutCharT>
+constexpr OutCharT* utf8_decode_chars(const InCharT* in, size_t count, OutCharT* out) noexcept {
+    static_assert(sizeof(OutCharT) == 2 || sizeof(OutCharT) == 4);
+    const InCharT* const end = in + count;
+    while (in != end) {
+        const size_t ascii = ascii_prefix_length(in, static_cast<size_t>(end - in));
+        out = copy_chars(in, ascii, out);
+        in += ascii;
+        if (in == end) break;
+        size_t invalid_len;
+        const size_t len = utf8_sequence_length(in, end, invalid_len);
+        if (len == 0) {
+            *out++ = static_cast<OutCharT>(replacement_character);
+            in += invalid_len;
+            continue;
+        }
+        const char32_t cp = utf8_decode(in, len);
+        in += len;
+        if (sizeof(OutCharT) == 2 && cp >= 0x10000) {
+            *out++ = static_cast<OutCharT>(0xD800 + ((cp - 0x10000) >> 10));
+            *out++ = static_cast<OutCharT>(0xDC00 + ((cp - 0x10000) & 0x3FF));
+        } else {
+            *out++ = static_cast<OutCharT>(cp);
+        }
+    }
+    return out;
 }
 
 }  // namespace detail
@@ -19,3 +19,8 @@ TEST_CASE("bool_writer") {
         REQUIRE(ch == '1');
     }
 }
+
+TEST_CASE("concat bool wide") {
+    REQUIRE(cat<wchar_t>(true, false).build() == L"10");
+    REQUIRE(cat<char16_t>(true).build() == u"1");
+}
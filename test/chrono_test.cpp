@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <ctime>
+#include <lazycat/lazycat.hpp>
+#include <string>
+
+using namespace lazycat;
+using namespace std::chrono;
+
+namespace {
+std::string strftime_iso8601(std::int64_t epoch_seconds) {
+    const std::time_t t = static_cast<std::time_t>(epoch_seconds);
+    std::tm tm;
+#if defined(_WIN32)
+    gmtime_s(&tm, &t);
+#else
+    gmtime_r(&t, &tm);
+#endif
+    char buf[64];
+    return std::string(buf, std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm));
+}
+}  // namespace
+
+TEST_CASE("iso8601") {
+    REQUIRE(iso8601_writer<>::size() == 20);
+    REQUIRE(cat(iso8601(system_clock::time_point{})).build() == "1970-01-01T00:00:00Z");
+    REQUIRE(cat(iso8601(sys_days{year{2000} / 2 / 29} + hours{23} + minutes{59} + seconds{58}))
+                .build() == "2000-02-29T23:59:58Z");
+    REQUIRE(cat(iso8601(sys_seconds{seconds{-1}})).build() == "1969-12-31T23:59:59Z");
+    REQUIRE(cat(iso8601(sys_days{year{9999} / 12 / 31})).build() == "9999-12-31T00:00:00Z");
+    REQUIRE(cat<wchar_t>(iso8601(sys_seconds{seconds{1700000000}})).build() ==
+            L"2023-11-14T22:13:20Z");
+    for (std::int64_t t = 0; t < 4000000000; t += 9876543) {
+        REQUIRE(cat(iso8601(sys_seconds{seconds{t}})).build() == strftime_iso8601(t));
+    }
+}
+
+TEST_CASE("rfc3339_micros") {
+    REQUIRE(rfc3339_micros_writer<>::size() == 27);
+    REQUIRE(cat(rfc3339_micros(sys_seconds{seconds{1700000000}} + microseconds{12})).build() ==
+            "2023-11-14T22:13:20.000012Z");
+    REQUIRE(cat(rfc3339_micros(system_clock::time_point{} - microseconds{1})).build() ==
+            "1969-12-31T23:59:59.999999Z");
+    REQUIRE(cat(rfc3339_micros(sys_seconds{seconds{1}} + nanoseconds{999999999})).build() ==
+            "1970-01-01T00:00:01.999999Z");
+}
+
+TEST_CASE("cached timestamps") {
+    for (std::int64_t us = 1700000000000000; us < 1700000005000000; us += 123457) {
+        const auto tp = sys_time<microseconds>{microseconds{us}};
+        REQUIRE(cat(cached_iso8601(tp)).build() == cat(iso8601(tp)).build());
+        REQUIRE(cat(cached_rfc3339_micros(tp)).build() == cat(rfc3339_micros(tp)).build());
+    }
+    REQUIRE(cat<char16_t>(cached_iso8601(sys_seconds{seconds{0}})).build() ==
+            u"1970-01-01T00:00:00Z");
+}
+
+TEST_CASE("duration") {
+    REQUIRE(cat(lazycat::duration(nanoseconds{0})).build() == "00:00:00.000000000");
+    REQUIRE(cat(lazycat::duration(milliseconds{1500})).build() == "00:00:01.500000000");
+    REQUIRE(cat(lazycat::duration(hours{2} + minutes{3} + seconds{4} + nanoseconds{5})).build() ==
+            "02:03:04.000000005");
+    REQUIRE(cat(lazycat::duration(-seconds{61})).build() == "-00:01:01.000000000");
+    REQUIRE(cat(lazycat::duration(hours{12345})).build() == "12345:00:00.000000000");
+    REQUIRE(cat(lazycat::duration(nanoseconds::min())).build() == "-2562047:47:16.854775808");
+    REQUIRE(cat<wchar_t>(lazycat::duration(microseconds{1})).build() == L"00:00:00.000001000");
+}
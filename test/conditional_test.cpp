@@ -0,0 +1,35 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <string>
+
+using namespace lazycat;
+
+TEST_CASE("concat nested catter") {
+    std::string host = "db1";
+    int pid = 42;
+    const auto prefix = cat('[', host, ':', pid, "] ");
+    REQUIRE(cat(prefix, "started").build() == "[db1:42] started");
+    REQUIRE(cat(prefix, prefix).build() == "[db1:42] [db1:42] ");
+    REQUIRE(cat(cat(cat(1), 2), cat()).build() == "12");
+    REQUIRE(cat<wchar_t>(prefix, L"wide").build() == L"[db1:42] wide");
+    std::string s = "log ";
+    append(s, prefix, "x").build();
+    REQUIRE(s == "log [db1:42] x");
+}
+
+TEST_CASE("when") {
+    std::string user = "alice";
+    REQUIRE(cat("a", when(true, " user=", user), "b").build() == "a user=aliceb");
+    REQUIRE(cat("a", when(false, " user=", user), "b").build() == "ab");
+    REQUIRE(cat(when(true)).build().empty());
+    REQUIRE(cat(when(true, 123, ' ', 4.5)).build() == "123 4.5");
+    REQUIRE(cat(when(false, 123)).build().empty());
+}
+
+TEST_CASE("either") {
+    REQUIRE(cat("status=", either(true, "ok", -1)).build() == "status=ok");
+    REQUIRE(cat("status=", either(false, "ok", -1)).build() == "status=-1");
+    const auto err = cat("error ", 404);
+    REQUIRE(cat(either(false, "fine", err)).build() == "error 404");
+    REQUIRE(cat<char16_t>(either(true, u"yes", u"no")).build() == u"yes");
+}
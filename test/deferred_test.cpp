@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_deferred.hpp>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace lazycat;
+
+namespace {
+std::vector<std::string> drain_all(deferred_sink& sink) {
+    std::vector<std::string> ret;
+    sink.drain([&](std::string_view message) { ret.emplace_back(message); });
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("deferred_sink formats like cat") {
+    deferred_sink sink(4096);
+    const std::string name = "order";
+    const std::string_view side = "buy";
+    const char* venue = "XNYS";
+    const std::int64_t id = std::numeric_limits<std::int64_t>::min();
+    const double price = 101.25;
+    const unsigned char qty = 200;
+    REQUIRE(sink.capture(name, ' ', id, ' ', side, " at ", price, " x ", qty, ' ', venue, ' ',
+                         true, ' ', -0.5f));
+    REQUIRE(sink.capture());
+    REQUIRE(drain_all(sink) ==
+            std::vector<std::string>{cat(name, ' ', id, ' ', side, " at ", price, " x ", qty, ' ',
+                                         venue, ' ', true, ' ', -0.5f),
+                                     ""});
+}
+
+TEST_CASE("deferred_sink only captures what cat<char> can write") {
+    static_assert(detail::is_capturable<char>::value);
+    static_assert(detail::is_capturable<bool>::value);
+    static_assert(detail::is_capturable<const char*>::value);
+    static_assert(!detail::is_capturable<wchar_t>::value);
+    static_assert(!detail::is_capturable<char16_t>::value);
+    static_assert(!detail::is_capturable<char32_t>::value);
+    static_assert(!detail::is_capturable<const wchar_t*>::value);
+    static_assert(!detail::is_capturable<std::vector<int>>::value);
+}
+
+TEST_CASE("deferred_sink copies strings") {
+    deferred_sink sink(1024);
+    std::string s = "before";
+    sink.capture("s=", s);
+    s = "after, and long enough not to fit in the small string buffer";
+    sink.capture("s=", s);
+    s.clear();
+    const std::vector<std::string> expected{
+        "s=before", "s=after, and long enough not to fit in the small string buffer"};
+    REQUIRE(drain_all(sink) == expected);
+}
+
+TEST_CASE("deferred_sink rejects captures that can never fit") {
+    deferred_sink sink(64);
+    REQUIRE(!sink.capture(std::string(64, 'x')));
+    REQUIRE(sink.capture(std::string(8, 'x')));
+    REQUIRE(drain_all(sink) == std::vector<std::string>{std::string(8, 'x')});
+}
+
+TEST_CASE("deferred_sink rejects strings of 4 GiB or more") {
+    // Lengths are stored in 32 bits.  The views are only measured, never read.
+    if constexpr (sizeof(size_t) > sizeof(std::uint32_t)) {
+        const char c = 'x';
+        const size_t limit = std::numeric_limits<std::uint32_t>::max();
+        REQUIRE(detail::capture_traits<std::string_view>::fits(std::string_view(&c, limit)));
+        REQUIRE(!detail::capture_traits<std::string_view>::fits(std::string_view(&c, limit + 1)));
+        deferred_sink sink(1024);
+        REQUIRE(!sink.capture("big: ", std::string_view(&c, limit + 1)));
+        REQUIRE(drain_all(sink).empty());
+    }
+}
+
+TEST_CASE("deferred_sink background worker") {
+    constexpr int count = 50000;
+    deferred_sink sink(2048);
+    std::atomic<bool> done{false};
+    std::vector<std::string> got;
+    std::thread worker([&] {
+        const auto collect = [&](std::string_view message) { got.emplace_back(message); };
+        while (!done.load()) {
+            if (sink.drain(collect) == 0) std::this_thread::yield();
+        }
+        sink.drain(collect);
+    });
+    for (int i = 0; i != count; ++i) sink.capture("line ", i, ' ', i * 0.5);
+    done = true;
+    worker.join();
+    REQUIRE(got.size() == count);
+    bool same = true;
+    for (int i = 0; i != count; ++i) same = same && got[i] == cat("line ", i, ' ', i * 0.5).build();
+    REQUIRE(same);
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_deflate.hpp>
+
+#if defined(LAZYCAT_HAS_ZLIB)
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+using namespace lazycat;
+
+namespace {
+std::string inflate_all(const std::string& compressed, int window_bits) {
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, window_bits) == Z_OK);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    std::string ret;
+    char buffer[4096];
+    int status;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        status = inflate(&stream, Z_NO_FLUSH);
+        REQUIRE((status == Z_OK || status == Z_STREAM_END));
+        ret.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (status != Z_STREAM_END);
+    inflateEnd(&stream);
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("deflate_sink basic") {
+    std::string compressed;
+    deflate_sink out([&](std::string_view chunk) { compressed += chunk; });
+    REQUIRE(out.is_open());
+    REQUIRE(cat_into(out, "id,name\n"));
+    REQUIRE(cat_into(out));
+    REQUIRE(cat_into(out, 1, ',', std::string("cat"), '\n'));
+    REQUIRE(out.bytes_in() == 14);
+    REQUIRE(out.finish());
+    REQUIRE(!out.is_open());
+    REQUIRE(!cat_into(out, "after finish"));
+    REQUIRE(compressed.substr(0, 2) == "\x1f\x8b");  // gzip magic
+    REQUIRE(inflate_all(compressed, 15 + 16) == "id,name\n1,cat\n");
+    REQUIRE(out.bytes_out() == compressed.size());
+}
+
+TEST_CASE("deflate_sink formats and small staging") {
+    for (const deflate_format format :
+         {deflate_format::gzip, deflate_format::zlib, deflate_format::raw}) {
+        std::string compressed, expected;
+        size_t chunks = 0;
+        {
+            // A staging buffer smaller than some records, so that they take the large path
+            deflate_sink out(
+                [&](std::string_view chunk) {
+                    REQUIRE(chunk.size() <= 64);
+                    compressed += chunk;
+                    ++chunks;
+                },
+                1, format, 64);
+            for (int i = 0; i != 2000; ++i) {
+                REQUIRE(cat_into(out, "row ", i, ' ', repeat("x", static_cast<size_t>(i % 100)),
+                                 '\n'));
+                expected += cat("row ", i, ' ', repeat("x", static_cast<size_t>(i % 100)), '\n');
+            }
+            // The destructor finishes the stream
+        }
+        REQUIRE(chunks > 1);
+        const int window_bits = format == deflate_format::gzip   ? 15 + 16
+                                : format == deflate_format::zlib ? 15
+                                                                 : -15;
+        REQUIRE(inflate_all(compressed, window_bits) == expected);
+    }
+}
+
+#if defined(__cpp_exceptions)
+TEST_CASE("deflate_sink destructor ignores exceptions from the output") {
+    bool called = false;
+    {
+        deflate_sink out([&](std::string_view) {
+            called = true;
+            throw std::runtime_error("connection closed");
+        });
+        REQUIRE(cat_into(out, "unfinished"));
+    }  // must not terminate
+    REQUIRE(called);
+}
+#endif
+
+TEST_CASE("deflate_sink flush") {
+    std::string compressed;
+    deflate_sink out([&](std::string_view chunk) { compressed += chunk; }, 6,
+                     deflate_format::raw);
+    REQUIRE(cat_into(out, "first record\n"));
+    REQUIRE(out.flush());
+    // Everything so far can be decompressed before the stream is finished
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, -15) == Z_OK);
+    char buffer[64];
+    stream.next_in = reinterpret_cast<Bytef*>(compressed.data());
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    stream.next_out = reinterpret_cast<Bytef*>(buffer);
+    stream.avail_out = sizeof(buffer);
+    REQUIRE(inflate(&stream, Z_SYNC_FLUSH) == Z_OK);
+    REQUIRE(std::string_view(buffer, sizeof(buffer) - stream.avail_out) == "first record\n");
+    inflateEnd(&stream);
+    REQUIRE(out.finish());
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <string>
+#include <utility>
+
+using namespace lazycat;
+
+TEST_CASE("dynamic_cat basic") {
+    dynamic_cat msg;
+    REQUIRE(msg.empty());
+    REQUIRE(msg.build().empty());
+    std::string query = "SELECT 1";
+    msg << "query=" << query;
+    bool log_time = true;
+    if (log_time) msg << " time=" << 12.5 << "ms";
+    msg.add(' ', -7, ' ', true, ' ', 'x');
+    REQUIRE(!msg.empty());
+    REQUIRE(msg.build() == "query=SELECT 1 time=12.5ms -7 1 x");
+    std::string s = msg;
+    REQUIRE(s == msg.build());
+    msg.clear();
+    REQUIRE(msg.build().empty());
+}
+
+TEST_CASE("dynamic_cat grows past the inline buffer") {
+    basic_dynamic_cat<char, 32> msg;
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        msg << i << ',';
+        expected += std::to_string(i) + ',';
+    }
+    REQUIRE(msg.build() == expected);
+    basic_dynamic_cat<char, 32> moved = std::move(msg);
+    REQUIRE(moved.build() == expected);
+    REQUIRE(msg.empty());
+}
+
+TEST_CASE("dynamic_cat move inline") {
+    dynamic_cat msg;
+    msg << "a" << 1;
+    dynamic_cat moved = std::move(msg);
+    REQUIRE(moved.build() == "a1");
+    msg = std::move(moved);
+    REQUIRE(msg.build() == "a1");
+}
+
+TEST_CASE("dynamic_cat with writers, catters and wide output") {
+    const auto prefix = cat("[", 42, "] ");
+    dynamic_cat msg;
+    msg << prefix << when(false, "hidden") << utf8_from(u"é");
+    REQUIRE(msg.build() == "[42] \xc3\xa9");
+    std::string s = "log ";
+    msg.append_to(s);
+    REQUIRE(s == "log [42] \xc3\xa9");
+
+    wdynamic_cat wmsg;
+    wmsg << L"n=" << 5 << "!";
+    REQUIRE(wmsg.build() == L"n=5!");
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cstring>
+#include <lazycat/lazycat.hpp>
+#include <string>
+#include <type_traits>
+
+using namespace lazycat;
+
+namespace geo {
+struct point {
+    int x, y;
+};
+struct size2d {
+    int w, h;
+};
+constexpr auto lazycat_writer(const size2d& s) noexcept {
+    return cat(s.w, 'x', s.h);
+}
+}  // namespace geo
+
+namespace app {
+struct point {
+    int x, y;
+};
+// An operator<< that adds several writers to the catter
+template <typename Catter, typename = std::enable_if_t<std::is_base_of_v<base_catter, Catter>>>
+constexpr auto operator<<(Catter c, const point& p) noexcept {
+    return c << p.x << ',' << p.y;
+}
+}  // namespace app
+
+template <>
+struct lazycat::writer_traits<geo::point> {
+    static constexpr auto make_writer(const geo::point& p) noexcept {
+        return cat('(', p.x, ", ", p.y, ')');
+    }
+};
+
+namespace money {
+struct cents {
+    long long value;
+};
+inline std::to_chars_result to_chars(char* first, char* last, const cents& c) {
+    auto res = std::to_chars(first, last, c.value / 100);
+    if (res.ec != std::errc{} || last - res.ptr < 3) return res;
+    *res.ptr++ = '.';
+    *res.ptr++ = static_cast<char>('0' + c.value % 100 / 10);
+    *res.ptr++ = static_cast<char>('0' + c.value % 10);
+    return res;
+}
+enum class level { info = 1 };
+inline std::to_chars_result to_chars(char* first, char* last, level l) {
+    const char* name = l == level::info ? "INFO" : "?";
+    const size_t len = std::strlen(name);
+    if (static_cast<size_t>(last - first) < len) return {last, std::errc::value_too_large};
+    std::memcpy(first, name, len);
+    return {first + len, std::errc{}};
+}
+// Always fails, like a value that does not fit in the buffer
+struct oversized {};
+inline std::to_chars_result to_chars(char*, char* last, const oversized&) {
+    return {last, std::errc::value_too_large};
+}
+}  // namespace money
+
+TEST_CASE("writer_traits specialization") {
+    geo::point p{3, -4};
+    REQUIRE(cat("p=", p).build() == "p=(3, -4)");
+    REQUIRE(cat<wchar_t>(p).build() == L"(3, -4)");
+}
+
+TEST_CASE("ADL operator<< with several writers") {
+    REQUIRE(cat("p=", app::point{1, 2}, ";").build() == "p=1,2;");
+    std::u16string s = u"[";
+    append(s, app::point{-3, 4}, u']').build();
+    REQUIRE(s == u"[-3,4]");
+    static_assert(cat_array([] { return cat(app::point{5, 6}); }).view() == "5,6");
+}
+
+TEST_CASE("ADL lazycat_writer") {
+    geo::size2d s{1920, 1080};
+    REQUIRE(cat(s, '!').build() == "1920x1080!");
+    dynamic_cat msg;
+    msg << "size=" << s;
+    REQUIRE(msg.build() == "size=1920x1080");
+}
+
+TEST_CASE("ADL to_chars") {
+    money::cents c{12345};
+    REQUIRE(cat('$', c).build() == "$123.45");
+    REQUIRE(cat<char16_t>(c).build() == u"123.45");
+    // an enum with a to_chars hook must not be converted to char or int
+    REQUIRE(cat('[', money::level::info, ']').build() == "[INFO]");
+}
+
+TEST_CASE("ADL to_chars failure writes nothing") {
+    REQUIRE(cat('[', money::oversized{}, ']').build() == "[]");
+    REQUIRE(cat<char32_t>(money::oversized{}, 1).build() == U"1");
+}
+
+TEST_CASE("ADL to_chars outlives the value") {
+    dynamic_cat msg;
+    for (long long i = 1; i != 4; ++i) msg << money::cents{i * 101} << ' ';
+    REQUIRE(msg.build() == "1.01 2.02 3.03 ");
+}
+
+#if defined(__cpp_concepts)
+TEST_CASE("writer concepts") {
+    STATIC_REQUIRE(Writer<integral_writer<int>>);
+    STATIC_REQUIRE(Writer<string_view_writer>);
+    STATIC_REQUIRE(Writer<decltype(cat(1, "a"))>);
+    STATIC_REQUIRE(!Writer<int>);
+    STATIC_REQUIRE(!Writer<std::string>);
+    STATIC_REQUIRE(ConstexprWriter<string_view_writer>);
+    STATIC_REQUIRE(ConstexprWriter<bool_writer>);
+    STATIC_REQUIRE(Writable<std::string>);
+    STATIC_REQUIRE(Writable<int>);
+    STATIC_REQUIRE(Writable<geo::point>);
+    STATIC_REQUIRE(Writable<geo::size2d>);
+    STATIC_REQUIRE(Writable<money::cents>);
+    STATIC_REQUIRE(!Writable<std::nullptr_t>);
+}
+#endif
@@ -1,8 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <charconv>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <lazycat/lazycat.hpp>
 #include <limits>
+#include <random>
 #include <string_view>
 
 using namespace lazycat;
@@ -46,3 +49,55 @@ TEST_CASE("floating_point_writer double") {
     test(std::numeric_limits<double>::infinity());
     test(std::numeric_limits<double>::quiet_NaN());
 }
+
+TEST_CASE("concat double wide") {
+    REQUIRE(cat<wchar_t>(-3243.454, L' ', 0.0).build() == L"-3243.454 0");
+    REQUIRE(cat<char16_t>(2.3456757e+55).build() == u"2.3456757e+55");
+    REQUIRE(cat<char32_t>(1.5).build() == U"1.5");
+}
+
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+namespace {
+template <typename T>
+void check_constexpr_to_chars(T val) {
+    char expected[64], actual[64];
+    char* expected_end = std::to_chars(expected, expected + 64, val).ptr;
+    REQUIRE(sv_from_ptrs(actual, detail::constexpr_to_chars(actual, val)) ==
+            sv_from_ptrs(expected, expected_end));
+}
+
+template <typename T, typename Bits>
+void check_constexpr_to_chars_all() {
+    // Powers of 2 (whose rounding interval is asymmetric) and their neighbours
+    for (int e = std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits;
+         e != std::numeric_limits<T>::max_exponent; ++e) {
+        const T power = std::ldexp(T{1}, e);
+        check_constexpr_to_chars(power);
+        check_constexpr_to_chars(std::nextafter(power, T{0}));
+        check_constexpr_to_chars(-std::nextafter(power, std::numeric_limits<T>::infinity()));
+    }
+    // Random bit patterns, short decimals, and integers around the switch to scientific notation
+    std::mt19937_64 rng(42);
+    for (int i = 0; i != 20000; ++i) {
+        const auto bits = static_cast<Bits>(rng());
+        T val;
+        std::memcpy(&val, &bits, sizeof(T));
+        check_constexpr_to_chars(val);
+        check_constexpr_to_chars(static_cast<T>(static_cast<double>(rng() % 100000) /
+                                                std::pow(10.0, static_cast<double>(rng() % 10))));
+        check_constexpr_to_chars(static_cast<T>(rng() >> (rng() % 64)));
+    }
+}
+}  // namespace
+
+TEST_CASE("constexpr_to_chars matches std::to_chars") {
+    check_constexpr_to_chars_all<float, std::uint32_t>();
+    check_constexpr_to_chars_all<double, std::uint64_t>();
+    check_constexpr_to_chars(0.0);
+    check_constexpr_to_chars(-0.0);
+    check_constexpr_to_chars(-std::numeric_limits<double>::infinity());
+    check_constexpr_to_chars(std::numeric_limits<double>::quiet_NaN());
+    check_constexpr_to_chars(123456789012345680000.0);  // written exactly
+    check_constexpr_to_chars(123456789.0f);
+}
+#endif
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <lazycat/lazycat.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace lazycat;
+
+namespace {
+std::uint32_t crc32c_of(std::string_view s) {
+    crc32c crc;
+    crc.update(s.data(), s.size());
+    return crc.value();
+}
+
+// Records the chunks passed by hashed_build().
+struct recording_hasher {
+    std::vector<std::string> chunks;
+    void update(const void* data, size_t size) {
+        chunks.emplace_back(static_cast<const char*>(data), size);
+    }
+};
+}  // namespace
+
+TEST_CASE("crc32c") {
+    REQUIRE(crc32c_of("") == 0);
+    REQUIRE(crc32c_of("123456789") == 0xE3069283);
+    REQUIRE(crc32c_of(std::string(32, '\0')) == 0x8A9136AA);
+    REQUIRE(crc32c_of(std::string(32, '\xFF')) == 0x62A8AB43);
+    // Incremental updates of every split give the same result
+    const std::string s = "The quick brown fox jumps over the lazy dog, 0123456789";
+    for (size_t i = 0; i <= s.size(); ++i) {
+        crc32c crc;
+        crc.update(s.data(), i);
+        crc.update(s.data() + i, s.size() - i);
+        REQUIRE(crc.value() == crc32c_of(s));
+    }
+}
+
+TEST_CASE("hashed_build") {
+    crc32c crc;
+    const std::string s = hashed_build(cat("id=", 42, ", name=", std::string("widget"), '\n'), crc);
+    REQUIRE(s == "id=42, name=widget\n");
+    REQUIRE(crc.value() == crc32c_of(s));
+
+    crc32c empty;
+    REQUIRE(hashed_build(cat(), empty).empty());
+    REQUIRE(empty.value() == 0);
+
+    crc32c chained;
+    const std::string t = hashed_build(cat() << std::string_view("a") << 1 << 'b', chained);
+    REQUIRE(t == "a1b");
+    REQUIRE(chained.value() == crc32c_of(t));
+}
+
+TEST_CASE("hashed_build chunks") {
+    const std::string field(100, 'x');
+    recording_hasher hasher;
+    const std::string s = hashed_build(
+        cat(field, ',', field, ',', field, ',', field, ',', repeat("0123456789", 60), '\n'),
+        hasher);
+    REQUIRE(s.size() == 4 * 101 + 600 + 1);
+    std::string fed;
+    for (size_t i = 0; i != hasher.chunks.size(); ++i) {
+        if (i + 1 != hasher.chunks.size()) REQUIRE(hasher.chunks[i].size() >= hash_chunk_size);
+        fed += hasher.chunks[i];
+    }
+    REQUIRE(hasher.chunks.size() > 1);
+    REQUIRE(fed == s);
+}
+
+TEST_CASE("hashed_build wide") {
+    crc32c crc;
+    const std::u16string s = hashed_build(cat<char16_t>(u"wide ", 7), crc);
+    REQUIRE(s == u"wide 7");
+    crc32c expected;
+    expected.update(s.data(), s.size() * sizeof(char16_t));
+    REQUIRE(crc.value() == expected.value());
+}
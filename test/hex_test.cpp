@@ -0,0 +1,45 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <lazycat/lazycat.hpp>
+#include <string>
+#include <vector>
+
+using namespace lazycat;
+
+namespace {
+std::string naive_hex(const std::vector<std::uint8_t>& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string ret;
+    for (std::uint8_t b : bytes) {
+        ret += digits[b >> 4];
+        ret += digits[b & 0x0F];
+    }
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("hex_bytes") {
+    std::vector<std::uint8_t> bytes;
+    for (size_t len = 0; len != 70; ++len) {
+        const auto writer = hex_bytes(bytes);
+        REQUIRE(writer.size() == len * 2);
+        REQUIRE(cat(writer).build() == naive_hex(bytes));
+        bytes.push_back(static_cast<std::uint8_t>(len * 37 + 11));
+    }
+    const std::array<std::uint8_t, 4> deadbeef = {0xde, 0xad, 0xbe, 0xef};
+    REQUIRE(cat("0x", hex_bytes(deadbeef)).build() == "0xdeadbeef");
+    REQUIRE(cat<wchar_t>(hex_bytes(deadbeef)).build() == L"deadbeef");
+    const std::array<std::byte, 2> raw = {std::byte{0x01}, std::byte{0xf0}};
+    REQUIRE(cat(hex_bytes(raw)).build() == "01f0");
+}
+
+TEST_CASE("uuid") {
+    const std::array<std::uint8_t, 16> id = {0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+                                             0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00};
+    REQUIRE(uuid_writer::size() == 36);
+    REQUIRE(cat(uuid(id)).build() == "123e4567-e89b-12d3-a456-426614174000");
+    REQUIRE(cat<char16_t>(uuid(id)).build() == u"123e4567-e89b-12d3-a456-426614174000");
+    const std::array<std::uint8_t, 16> nil{};
+    REQUIRE(cat(uuid(nil)).build() == "00000000-0000-0000-0000-000000000000");
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <string>
+#include <string_view>
+
+using namespace lazycat;
+
+namespace {
+const instrumentation::writer_stats* find_writer(const instrumentation::stats& stats,
+                                                 std::string_view name) {
+    for (const auto& w : stats.writers) {
+        if (w.writer.find(name) != std::string_view::npos) return &w;
+    }
+    return nullptr;
+}
+}  // namespace
+
+TEST_CASE("instrumentation cat") {
+    instrumentation::reset();
+    const std::string long_str(100, 'x');
+    std::string s = cat("a", 12345, long_str);
+    REQUIRE(s.size() == 106);
+    std::string short_s = cat("b", 1);
+    const auto stats = instrumentation::snapshot();
+    if constexpr (instrumentation::enabled) {
+        REQUIRE(stats.materializations == 2);
+        REQUIRE(stats.allocations == 1);  // only the long one does not fit in the SSO buffer
+        REQUIRE(stats.allocated_bytes >= 107);
+        REQUIRE(stats.appends == 0);
+        const auto* integral = find_writer(stats, "integral_writer<int>");
+        REQUIRE(integral != nullptr);
+        REQUIRE(integral->size_calls == 2);
+        REQUIRE(integral->write_calls == 2);
+    } else {
+        REQUIRE(stats.materializations == 0);
+        REQUIRE(stats.writers.empty());
+    }
+}
+
+TEST_CASE("instrumentation nested catters") {
+    instrumentation::reset();
+    std::string s = cat(cat("a", 1), 2);
+    REQUIRE(s == "a12");
+    const auto stats = instrumentation::snapshot();
+    if constexpr (instrumentation::enabled) {
+        REQUIRE(stats.materializations == 1);
+        const auto* integral = find_writer(stats, "integral_writer<int>");
+        REQUIRE(integral != nullptr);
+        REQUIRE(integral->size_calls == 2);
+        // The nested catter is not a writer of its own
+        const auto* nested = find_writer(stats, "catter");
+        REQUIRE((nested == nullptr || nested->size_calls == 0));
+    }
+}
+
+TEST_CASE("instrumentation append") {
+    instrumentation::reset();
+    std::string s;
+    for (int i = 0; i != 1000; ++i) append(s, "line ", i, '\n').build();
+    const auto stats = instrumentation::snapshot();
+    if constexpr (instrumentation::enabled) {
+        REQUIRE(stats.appends == 1000);
+        REQUIRE(stats.materializations == 0);
+        // Geometric growth: few reallocations
+        REQUIRE(stats.reallocations >= 1);
+        REQUIRE(stats.reallocations < 40);
+        const auto* integral = find_writer(stats, "integral_writer<int>");
+        REQUIRE(integral != nullptr);
+        REQUIRE(integral->write_calls == 1000);
+    } else {
+        REQUIRE(stats.appends == 0);
+    }
+}
+
+TEST_CASE("instrumentation reset") {
+    std::string s = cat("a", 1);
+    instrumentation::reset();
+    const auto stats = instrumentation::snapshot();
+    REQUIRE(stats.materializations == 0);
+    for (const auto& w : stats.writers) {
+        REQUIRE(w.size_calls == 0);
+        REQUIRE(w.write_nanoseconds == 0);
+    }
+}
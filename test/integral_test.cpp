@@ -3,7 +3,13 @@
 #include <cstdint>
 #include <lazycat/lazycat.hpp>
 #include <limits>
+#include <random>
+#include <span>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 using namespace lazycat;
 
@@ -105,3 +111,252 @@ TEST_CASE("concat int") {
     REQUIRE(cat(a).build() == "10");
     REQUIRE(cat(b, a).build() == "1234510");
 }
+
+TEST_CASE("concat int64 limits") {
+    REQUIRE(cat(std::numeric_limits<std::int64_t>::min()).build() == "-9223372036854775808");
+    REQUIRE(cat(std::numeric_limits<std::int64_t>::max()).build() == "9223372036854775807");
+    REQUIRE(cat(std::numeric_limits<std::int32_t>::min()).build() == "-2147483648");
+}
+
+TEST_CASE("concat int wide") {
+    int a = -10;
+    unsigned long long b = 18446744073709551615ull;
+    REQUIRE(cat<wchar_t>(L"x", a, b).build() == L"x-1018446744073709551615");
+    REQUIRE(cat<char16_t>(a, u'/', 0).build() == u"-10/0");
+    REQUIRE(cat<char32_t>(b).build() == U"18446744073709551615");
+    REQUIRE(cat<char8_t>(a).build() == u8"-10");
+}
+
+namespace {
+// Checks that parse_integral agrees with std::from_chars on the given text.
+template <typename T>
+void check_parse(std::string_view text) {
+    T expected{}, actual{};
+    const auto e = std::from_chars(text.data(), text.data() + text.size(), expected);
+    const auto a = parse_integral(text.data(), text.data() + text.size(), actual);
+    INFO(text);
+    REQUIRE(a.ec == e.ec);
+    REQUIRE(a.ptr == e.ptr);
+    if (a.ec == std::errc{}) REQUIRE(actual == expected);
+}
+
+// Round-trips values of every digit length through integral_writer and parse_integral.
+template <typename T>
+void check_round_trip(std::mt19937_64& rng) {
+    using U = std::make_unsigned_t<T>;
+    for (int bits = 1; bits <= std::numeric_limits<U>::digits; ++bits) {
+        for (int i = 0; i != 50; ++i) {
+            const U magnitude = static_cast<U>(rng()) >> (std::numeric_limits<U>::digits - bits);
+            const T val = static_cast<T>(magnitude);
+            const std::string text = cat(val, ';');
+            T parsed{};
+            const auto r = parse_integral(text.data(), text.data() + text.size(), parsed);
+            REQUIRE(r.ec == std::errc{});
+            REQUIRE(r.ptr == text.data() + text.size() - 1);
+            REQUIRE(parsed == val);
+        }
+    }
+    for (T val : {std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), T{0}}) {
+        const std::string text = cat(val);
+        T parsed{};
+        REQUIRE(parse_integral(text.data(), text.data() + text.size(), parsed).ec == std::errc{});
+        REQUIRE(parsed == val);
+    }
+}
+}  // namespace
+
+TEST_CASE("parse_integral round trip") {
+    std::mt19937_64 rng(42);
+    check_round_trip<std::int8_t>(rng);
+    check_round_trip<std::uint8_t>(rng);
+    check_round_trip<std::int16_t>(rng);
+    check_round_trip<std::uint16_t>(rng);
+    check_round_trip<std::int32_t>(rng);
+    check_round_trip<std::uint32_t>(rng);
+    check_round_trip<std::int64_t>(rng);
+    check_round_trip<std::uint64_t>(rng);
+}
+
+TEST_CASE("parse_integral matches from_chars") {
+    const char* cases[] = {"",
+                           "-",
+                           "+1",
+                           " 1",
+                           "0",
+                           "-0",
+                           "00000000000000000000000000000042",
+                           "007x",
+                           "12345678",
+                           "123456789",
+                           "1234567890123456",
+                           "12345678901234567",
+                           "123a5678901234567",
+                           "1234567890123456a",
+                           "127",
+                           "128",
+                           "-128",
+                           "-129",
+                           "255",
+                           "256",
+                           "2147483647",
+                           "2147483648",
+                           "-2147483648",
+                           "-2147483649",
+                           "4294967295",
+                           "4294967296",
+                           "9223372036854775807",
+                           "9223372036854775808",
+                           "-9223372036854775808",
+                           "-9223372036854775809",
+                           "18446744073709551615",
+                           "18446744073709551616",
+                           "99999999999999999999",
+                           "100000000000000000000",
+                           "123456789012345678901234567890,next",
+                           "9:/0"};
+    for (std::string_view text : cases) {
+        check_parse<std::int8_t>(text);
+        check_parse<std::uint8_t>(text);
+        check_parse<std::int32_t>(text);
+        check_parse<std::uint32_t>(text);
+        check_parse<std::int64_t>(text);
+        check_parse<std::uint64_t>(text);
+    }
+    // Random strings of digits and a few other characters
+    std::mt19937_64 rng(7);
+    const char alphabet[] = "0123456789012345678901234567890123456789-,x";
+    for (int i = 0; i != 20000; ++i) {
+        std::string text(rng() % 24, '0');
+        for (char& c : text) c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        check_parse<std::int32_t>(text);
+        check_parse<std::uint64_t>(text);
+        check_parse<std::int64_t>(text);
+    }
+    // Only zeros, in a view of a larger buffer (the digits after the view must not be read)
+    std::string buffer(64, '0');
+    buffer[40] = '5';
+    buffer[41] = ',';
+    for (size_t length : {1, 8, 21, 24, 32, 40}) {
+        const std::string_view text(buffer.data(), length);
+        check_parse<std::int32_t>(text);
+        check_parse<std::uint64_t>(text);
+        check_parse<std::int64_t>(text);
+    }
+}
+
+namespace {
+// Values around every power of 10 and the limits, then random values of every bit width.
+template <typename T>
+std::vector<T> digit_count_values(std::mt19937_64& rng) {
+    std::vector<T> ret = {0, 1, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()};
+    for (T power = 1;; power *= 10) {
+        for (T v : {T(power - 1), power, T(power + 1)}) {
+            ret.push_back(v);
+            if constexpr (std::is_signed_v<T>) ret.push_back(T(-v));
+        }
+        if (power > std::numeric_limits<T>::max() / 10) break;
+    }
+    for (int i = 0; i != 1000; ++i) {
+        ret.push_back(static_cast<T>(rng() >> (rng() % 64)));
+    }
+    return ret;
+}
+
+template <typename T>
+void check_digit_counts(std::mt19937_64& rng) {
+    const std::vector<T> values = digit_count_values<T>(rng);
+    // Every length and offset, for the vector loops and the scalar tails
+    for (size_t first = 0; first != 9; ++first) {
+        for (size_t n : {size_t{0}, size_t{1}, size_t{3}, size_t{4}, size_t{7}, size_t{8},
+                         size_t{9}, size_t{17}, values.size() - first}) {
+            const std::span<const T> span(values.data() + first, n);
+            std::vector<std::uint8_t> counts(n + 1, 0xFF);
+            detail::digit_counts(span, counts.data());
+            size_t expected_total = 0;
+            for (size_t i = 0; i != n; ++i) {
+                const size_t expected = detail::calculate_integral_size<
+                    std::numeric_limits<std::make_unsigned_t<T>>::digits10 + 1>(span[i]);
+                REQUIRE(counts[i] == expected);
+                expected_total += expected;
+            }
+            REQUIRE(counts[n] == 0xFF);
+            REQUIRE(detail::total_size(span) == expected_total);
+        }
+    }
+}
+}  // namespace
+
+TEST_CASE("digit_counts matches calculate_integral_size") {
+    std::mt19937_64 rng(42);
+    check_digit_counts<std::int8_t>(rng);
+    check_digit_counts<std::uint8_t>(rng);
+    check_digit_counts<std::int16_t>(rng);
+    check_digit_counts<std::uint16_t>(rng);
+    check_digit_counts<std::int32_t>(rng);
+    check_digit_counts<std::uint32_t>(rng);
+    check_digit_counts<std::int64_t>(rng);
+    check_digit_counts<std::uint64_t>(rng);
+}
+
+namespace {
+template <typename T>
+void check_branchless(std::mt19937_64& rng) {
+    for (T v : digit_count_values<T>(rng)) {
+        REQUIRE(std::string(cat(branchless(v))) == std::string(cat(v)));
+        REQUIRE(std::string(cat('[', branchless(v), ']')) == std::string(cat('[', v, ']')));
+    }
+}
+}  // namespace
+
+TEST_CASE("branchless matches integral_writer") {
+    std::mt19937_64 rng(7);
+    check_branchless<signed char>(rng);
+    check_branchless<unsigned char>(rng);
+    check_branchless<std::int16_t>(rng);
+    check_branchless<std::uint16_t>(rng);
+    check_branchless<std::int32_t>(rng);
+    check_branchless<std::uint32_t>(rng);
+    check_branchless<std::int64_t>(rng);
+    check_branchless<std::uint64_t>(rng);
+    REQUIRE(std::wstring(cat<wchar_t>(branchless(-1234567890123LL))) == L"-1234567890123");
+    constexpr auto compile_time = cat_array([] { return cat(branchless(-42), branchless(7u)); });
+    static_assert(compile_time.view() == "-427");
+}
+
+namespace {
+template <typename T, typename = void>
+constexpr bool has_branchless = false;
+template <typename T>
+constexpr bool has_branchless<T, std::void_t<decltype(branchless(std::declval<T>()))>> = true;
+}  // namespace
+
+TEST_CASE("branchless is limited to 64-bit integers") {
+    STATIC_REQUIRE(has_branchless<std::int64_t>);
+    STATIC_REQUIRE(has_branchless<std::uint8_t>);
+    STATIC_REQUIRE(!has_branchless<bool>);
+    STATIC_REQUIRE(!has_branchless<double>);
+#if defined(__SIZEOF_INT128__)
+    STATIC_REQUIRE(!has_branchless<__int128>);
+    STATIC_REQUIRE(!has_branchless<unsigned __int128>);
+#endif
+}
+
+TEST_CASE("bit_width_nonzero") {
+    static_assert(detail::bit_width_nonzero(1u) == 1);
+    static_assert(detail::bit_width_nonzero(std::uint8_t{255}) == 8);
+    static_assert(detail::bit_width_nonzero(std::numeric_limits<std::uint64_t>::max()) == 64);
+    static_assert(cat_array([] {
+                      return cat(std::numeric_limits<std::int64_t>::min(), ' ',
+                                 std::numeric_limits<std::uint64_t>::max());
+                  }).view() == "-9223372036854775808 18446744073709551615");
+    for (unsigned i = 0; i != 64; ++i) {
+        REQUIRE(detail::bit_width_nonzero(std::uint64_t{1} << i) == i + 1);
+        REQUIRE(detail::bit_width_nonzero((std::uint64_t{2} << i) - 1) == i + 1);
+    }
+#if defined(__SIZEOF_INT128__) && !defined(__STRICT_ANSI__)  // an unsigned type in GNU mode
+    static_assert(detail::bit_width_nonzero(static_cast<unsigned __int128>(1)) == 1);
+    for (unsigned i = 0; i != 128; ++i) {
+        REQUIRE(detail::bit_width_nonzero(static_cast<unsigned __int128>(1) << i) == i + 1);
+    }
+#endif
+}
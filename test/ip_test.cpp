@@ -0,0 +1,61 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <lazycat/lazycat.hpp>
+#include <string>
+
+using namespace lazycat;
+
+namespace {
+std::array<std::uint8_t, 16> groups(std::array<std::uint16_t, 8> g) {
+    std::array<std::uint8_t, 16> ret;
+    for (size_t i = 0; i != 8; ++i) {
+        ret[i * 2] = static_cast<std::uint8_t>(g[i] >> 8);
+        ret[i * 2 + 1] = static_cast<std::uint8_t>(g[i] & 0xFF);
+    }
+    return ret;
+}
+std::string ipv6_string(std::array<std::uint16_t, 8> g) {
+    const auto writer = ipv6(groups(g));
+    std::string ret = cat(writer);
+    REQUIRE(writer.size() == ret.size());
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("ipv4") {
+    REQUIRE(cat(ipv4(0)).build() == "0.0.0.0");
+    REQUIRE(cat(ipv4(0xC0A80001)).build() == "192.168.0.1");
+    REQUIRE(cat(ipv4(0xFFFFFFFF)).build() == "255.255.255.255");
+    REQUIRE(cat<wchar_t>(ipv4(0x0A000A63)).build() == L"10.0.10.99");
+    for (std::uint64_t i = 0; i <= 0xFFFFFFFF; i += 0x00A5F3B7) {
+        const std::uint32_t addr = static_cast<std::uint32_t>(i);
+        char expected[16];
+        const int len = std::snprintf(expected, sizeof(expected), "%u.%u.%u.%u", addr >> 24,
+                                      (addr >> 16) & 0xFF, (addr >> 8) & 0xFF, addr & 0xFF);
+        const auto writer = ipv4(addr);
+        REQUIRE(writer.size() == static_cast<size_t>(len));
+        REQUIRE(cat(writer).build() == expected);
+    }
+}
+
+TEST_CASE("ipv6") {
+    REQUIRE(ipv6_string({0, 0, 0, 0, 0, 0, 0, 0}) == "::");
+    REQUIRE(ipv6_string({0, 0, 0, 0, 0, 0, 0, 1}) == "::1");
+    REQUIRE(ipv6_string({1, 0, 0, 0, 0, 0, 0, 0}) == "1::");
+    REQUIRE(ipv6_string({0x2001, 0xdb8, 0, 0, 0, 0, 0x2, 0x1}) == "2001:db8::2:1");
+    // a single zero group is not compressed
+    REQUIRE(ipv6_string({0x2001, 0xdb8, 0, 1, 1, 1, 1, 1}) == "2001:db8:0:1:1:1:1:1");
+    // the longest run is compressed, and the first one on a tie
+    REQUIRE(ipv6_string({0x2001, 0, 0, 1, 0, 0, 0, 1}) == "2001:0:0:1::1");
+    REQUIRE(ipv6_string({0x2001, 0xdb8, 0, 0, 1, 0, 0, 1}) == "2001:db8::1:0:0:1");
+    REQUIRE(ipv6_string({0xfe80, 0, 0, 0, 0x0202, 0xb3ff, 0xfe1e, 0x8329}) ==
+            "fe80::202:b3ff:fe1e:8329");
+    REQUIRE(ipv6_string({0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff}) ==
+            "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff");
+    // IPv4-mapped
+    REQUIRE(ipv6_string({0, 0, 0, 0, 0, 0xffff, 0xc000, 0x0280}) == "::ffff:192.0.2.128");
+    REQUIRE(cat<char32_t>(ipv6(groups({0x2001, 0xdb8, 0, 0, 0, 0, 0, 1}))).build() ==
+            U"2001:db8::1");
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_mmap.hpp>
+
+#if defined(LAZYCAT_HAS_MMAP)
+
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+using namespace lazycat;
+
+namespace {
+// A path in the temporary directory, unique to this process (the unit test binaries run in
+// parallel under ctest -j)
+std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / cat("lazycat_", getpid(), '_', name).build())
+        .string();
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+TEST_CASE("mmap_file_sink basic") {
+    const std::string path = temp_path("mmap_basic.txt");
+    mmap_file_sink out;
+    REQUIRE(out.open(path.c_str()));
+    REQUIRE(out.is_open());
+    REQUIRE(cat_into(out, "id,name\n"));
+    REQUIRE(cat_into(out));
+    REQUIRE(cat_into(out, 1, ',', std::string("cat"), '\n'));
+    REQUIRE(out.size() == 14);
+    REQUIRE(out.close());
+    REQUIRE(!out.is_open());
+    REQUIRE(read_file(path) == "id,name\n1,cat\n");
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("mmap_file_sink grows across extents") {
+    const std::string path = temp_path("mmap_extents.txt");
+    std::string expected;
+    {
+        mmap_file_sink out;
+        // One-page extents and flushes, so that records regularly cross window boundaries
+        REQUIRE(out.open(path.c_str(), 1, 1));
+        for (int i = 0; i != 20000; ++i) {
+            REQUIRE(cat_into(out, "row ", i, ' ', i * 0.5, '\n'));
+            expected += cat("row ", i, ' ', i * 0.5).build() + '\n';
+        }
+        // A record larger than an extent
+        const std::string big(100000, 'x');
+        REQUIRE(cat_into(out, big, '\n'));
+        expected += big + '\n';
+        REQUIRE(out.size() == expected.size());
+    }  // the destructor closes the file
+    REQUIRE(read_file(path) == expected);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("mmap_file_sink reopen truncates") {
+    const std::string path = temp_path("mmap_reopen.txt");
+    mmap_file_sink out;
+    REQUIRE(out.open(path.c_str()));
+    REQUIRE(cat_into(out, "a long first version"));
+    REQUIRE(out.open(path.c_str()));
+    REQUIRE(cat_into(out, "short"));
+    REQUIRE(out.close());
+    REQUIRE(read_file(path) == "short");
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("mmap_file_sink errors") {
+    mmap_file_sink out;
+    REQUIRE(!cat_into(out, "not open"));
+    REQUIRE(out.error() == EBADF);
+    REQUIRE(!out.open(temp_path("no_such_directory/file.txt").c_str()));
+    REQUIRE(out.error() == ENOENT);
+    REQUIRE(out.close());
+}
+
+#endif
@@ -0,0 +1,33 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <string>
+
+using namespace lazycat;
+
+TEST_CASE("fill") {
+    REQUIRE(fill(' ', 0).size() == 0);
+    REQUIRE(cat('[', fill(' ', 0), ']').build() == "[]");
+    REQUIRE(cat('[', fill(' ', 5), ']').build() == "[     ]");
+    REQUIRE(cat(fill('-', 1000)).build() == std::string(1000, '-'));
+    REQUIRE(cat<wchar_t>(fill(L'*', 3), fill('.', 2)).build() == L"***..");
+    REQUIRE(cat<char16_t>(fill(u'=', 40)).build() == std::u16string(40, u'='));
+}
+
+TEST_CASE("repeat") {
+    REQUIRE(repeat("ab", 3).size() == 6);
+    REQUIRE(cat(repeat("ab", 0)).build().empty());
+    REQUIRE(cat(repeat("", 10)).build().empty());
+    REQUIRE(cat(repeat("x", 4)).build() == "xxxx");
+    REQUIRE(cat(repeat("-+", 1)).build() == "-+");
+    for (size_t n = 0; n != 40; ++n) {
+        std::string expected;
+        for (size_t i = 0; i != n; ++i) expected += "abc";
+        REQUIRE(cat('|', repeat("abc", n), '|').build() == '|' + expected + '|');
+    }
+    REQUIRE(cat<wchar_t>(repeat("ab", 3), repeat(L"yz", 2)).build() == L"abababyzyz");
+    REQUIRE(cat<char32_t>(repeat(U"é", 3)).build() == U"ééé");
+    REQUIRE(cat<char16_t>(repeat("\xe9", 2)).build() == u"\ufffd\ufffd");
+    std::string s = "  ";
+    append(s, repeat("  ", 2), "x").build();
+    REQUIRE(s == "      x");
+}
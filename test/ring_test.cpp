@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_ring.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace lazycat;
+
+namespace {
+std::vector<std::string> drain_all(ring_sink& ring) {
+    std::vector<std::string> ret;
+    ring.drain([&](std::string_view message) { ret.emplace_back(message); });
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("ring_sink basic") {
+    ring_sink ring(100);
+    REQUIRE(ring.capacity() == 128);
+    REQUIRE(drain_all(ring).empty());
+    REQUIRE(cat_into(ring, "a=", 1, ' ', true));
+    REQUIRE(cat_into(ring, std::string("b"), '=', -2.5));
+    REQUIRE(cat_into(ring));
+    REQUIRE(drain_all(ring) == std::vector<std::string>{"a=1 1", "b=-2.5", ""});
+    REQUIRE(drain_all(ring).empty());
+}
+
+TEST_CASE("ring_sink wraps around") {
+    ring_sink ring(256);
+    std::vector<std::string> expected, got;
+    // Lengths that do not divide the capacity, so reservations cross the end
+    for (int i = 0; i != 1000; ++i) {
+        const std::string payload(i % 37, static_cast<char>('a' + i % 26));
+        REQUIRE(cat_into(ring, i, ':', payload));
+        expected.push_back(std::to_string(i) + ':' + payload);
+        ring.drain([&](std::string_view message) { got.emplace_back(message); });
+    }
+    REQUIRE(got == expected);
+}
+
+TEST_CASE("ring_sink rejects messages that can never fit") {
+    ring_sink ring(64);
+    REQUIRE(ring.max_message_size() == 48);
+    REQUIRE(cat_into(ring, std::string(48, 'x')));
+    REQUIRE(!cat_into(ring, std::string(49, 'x')));
+    REQUIRE(!try_cat_into(ring, std::string(49, 'x')));
+    REQUIRE(drain_all(ring) == std::vector<std::string>{std::string(48, 'x')});
+}
+
+TEST_CASE("ring_sink try_cat_into when full") {
+    ring_sink ring(128);
+    // Each record takes 16 bytes of header plus 16 bytes of payload
+    for (int i = 0; i != 4; ++i) REQUIRE(try_cat_into(ring, "0123456789abcde", i));
+    REQUIRE(!try_cat_into(ring, "x"));
+    REQUIRE(drain_all(ring).size() == 4);
+    REQUIRE(try_cat_into(ring, "x"));
+    REQUIRE(drain_all(ring) == std::vector<std::string>{"x"});
+}
+
+TEST_CASE("ring_sink ignores headers in stale messages") {
+    ring_sink ring(128);
+    // A message whose bytes at offset 32 of the buffer look like the header that the next lap
+    // commits there (tag = position + 1, span, length), with a length past the end
+    std::string forged(48, 'x');
+    const std::uint64_t tag = 128 + 32 + 1;
+    const std::uint32_t span = 16, length = 1000;
+    std::memcpy(&forged[16], &tag, 8);
+    std::memcpy(&forged[24], &span, 4);
+    std::memcpy(&forged[28], &length, 4);
+    REQUIRE(cat_into(ring, forged));
+    REQUIRE(drain_all(ring).size() == 1);
+    // Up to position 160: the next drain must stop there, at offset 32, which nothing committed
+    REQUIRE(cat_into(ring, std::string(48, 'a')));
+    REQUIRE(cat_into(ring));
+    REQUIRE(cat_into(ring));
+    REQUIRE(drain_all(ring) == std::vector<std::string>{std::string(48, 'a'), "", ""});
+    REQUIRE(cat_into(ring, "next"));
+    REQUIRE(drain_all(ring) == std::vector<std::string>{"next"});
+}
+
+TEST_CASE("ring_sink capacity fits in a record header") {
+    STATIC_REQUIRE(ring_sink::max_capacity <= std::uint64_t{1} << 31);
+}
+
+TEST_CASE("ring_sink drain_to") {
+    ring_sink ring(1024);
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    cat_into(ring, "first ", 1, '\n');
+    cat_into(ring, "second ", 2, '\n');
+    REQUIRE(ring.drain_to(file) == 2);
+    std::rewind(file);
+    char buffer[64] = {};
+    const size_t n = std::fread(buffer, 1, sizeof(buffer), file);
+    std::fclose(file);
+    REQUIRE(std::string_view(buffer, n) == "first 1\nsecond 2\n");
+}
+
+TEST_CASE("ring_sink multiple producers") {
+    constexpr int producers = 4;
+    constexpr int per_producer = 20000;
+    // Small enough that producers regularly wait for the consumer
+    ring_sink ring(4096);
+    std::atomic<int> done{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p != producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i != per_producer; ++i) {
+                if (i % 2 == 0) {
+                    cat_into(ring, 'p', p, ' ', i);
+                } else {
+                    while (!try_cat_into(ring, 'p', p, ' ', i)) std::this_thread::yield();
+                }
+            }
+            ++done;
+        });
+    }
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    const auto check = [&](std::string_view message) {
+        const int p = message[1] - '0';
+        const std::string expected = cat('p', p, ' ', next[p]++);
+        ordered = ordered && message == expected;
+        ++received;
+    };
+    while (done.load() != producers) {
+        if (ring.drain(check) == 0) std::this_thread::yield();
+    }
+    ring.drain(check);
+    for (auto& t : threads) t.join();
+    REQUIRE(ordered);
+    REQUIRE(received == producers * per_producer);
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_scan.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace lazycat;
+
+namespace {
+std::vector<std::string_view> split_all(std::string_view s, char delimiter) {
+    std::vector<std::string_view> ret;
+    for (std::string_view field : split(s, delimiter)) ret.push_back(field);
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("scan basic") {
+    int id = 0;
+    std::string_view name;
+#if defined(LAZYCAT_HAS_FLOATING_POINT_SCAN)
+    double price = 0;
+#else
+    std::string_view price;
+#endif
+    bool active = false;
+    const auto r = scan("42,widget,3.25,1", id, ',', name, ',', price, ',', active);
+    REQUIRE(r);
+    REQUIRE(r.rest.empty());
+    REQUIRE(id == 42);
+    REQUIRE(name == "widget");
+#if defined(LAZYCAT_HAS_FLOATING_POINT_SCAN)
+    REQUIRE(price == 3.25);
+#else
+    REQUIRE(price == "3.25");
+#endif
+    REQUIRE(active);
+}
+
+TEST_CASE("scan literals") {
+    int a = 0, b = 0;
+    const std::string_view arrow = " -> ";
+    REQUIRE(scan("from 1 -> 2 end", "from ", a, arrow, b, std::string(" end")));
+    REQUIRE((a == 1 && b == 2));
+    // A non-const string_view is an output, and the rest of the input if it is last
+    std::string_view tail;
+    const auto r = scan("7:everything else", a, ':', tail);
+    REQUIRE(r);
+    REQUIRE(a == 7);
+    REQUIRE(tail == "everything else");
+    REQUIRE(r.rest.empty());
+    // A string_view output ends at a string literal too
+    std::string_view key;
+    REQUIRE(scan("key := 5", key, " := ", a));
+    REQUIRE((key == "key" && a == 5));
+}
+
+TEST_CASE("scan failures") {
+    int a = 0;
+    std::string_view s;
+    REQUIRE(!scan("x1", a));
+    REQUIRE(!scan("1;2", a, ',', a));
+    REQUIRE(!scan("abc", s, ','));
+    REQUIRE(!scan("99999999999", a));  // out of range
+    bool b = false;
+    REQUIRE(!scan("2", b));
+    // rest is where parsing stopped
+    const auto r = scan("12,x", a, ',', a);
+    REQUIRE(!r);
+    REQUIRE(a == 12);
+    REQUIRE(r.rest == "x");
+    // Trailing input is not an error
+    const auto partial = scan("12 trailing", a);
+    REQUIRE(partial);
+    REQUIRE(partial.rest == " trailing");
+}
+
+#if defined(LAZYCAT_HAS_FLOATING_POINT_SCAN)
+TEST_CASE("scan round trip") {
+    const std::int64_t i64s[] = {0, -1, 1, std::numeric_limits<std::int64_t>::min(),
+                                 std::numeric_limits<std::int64_t>::max()};
+    const double doubles[] = {0.0, -0.5, 1e300, 5e-324, 0.1, 123456.789};
+    for (std::int64_t i : i64s) {
+        for (double d : doubles) {
+            const std::uint32_t u = static_cast<std::uint32_t>(i);
+            const std::string line = cat(i, '\t', d, '\t', u, "\tname");
+            std::int64_t i2 = 0;
+            double d2 = 0;
+            std::uint32_t u2 = 0;
+            std::string_view name;
+            REQUIRE(scan(line, i2, '\t', d2, '\t', u2, '\t', name));
+            REQUIRE(i2 == i);
+            REQUIRE(d2 == d);
+            REQUIRE(u2 == u);
+            REQUIRE(name == "name");
+        }
+    }
+}
+#endif
+
+TEST_CASE("split") {
+    REQUIRE(split_all("a,b,c", ',') == std::vector<std::string_view>{"a", "b", "c"});
+    REQUIRE(split_all("", ',') == std::vector<std::string_view>{""});
+    REQUIRE(split_all(",a,,", ',') == std::vector<std::string_view>{"", "a", "", ""});
+    REQUIRE(split_all("no delimiter", ',') == std::vector<std::string_view>{"no delimiter"});
+}
+
+TEST_CASE("split long fields") {
+    // Fields longer than the SIMD blocks, with delimiters at every offset within a block
+    std::string line;
+    std::vector<std::string> expected;
+    for (int len = 0; len != 70; ++len) {
+        expected.push_back(
+            std::string(static_cast<size_t>(len), static_cast<char>('a' + len % 26)));
+        line += expected.back();
+        if (len != 69) line += '|';
+    }
+    const auto fields = split_all(line, '|');
+    REQUIRE(fields.size() == expected.size());
+    for (size_t i = 0; i != fields.size(); ++i) REQUIRE(fields[i] == expected[i]);
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <lazycat/lazycat.hpp>
+#include <limits>
+#include <string>
+#include <string_view>
+
+using namespace lazycat;
+
+namespace {
+constexpr std::int64_t table_size = 1000;
+
+constexpr auto metric = static_cat<fixed_string("http.status."), 404, '.', fixed_string("count")>();
+constexpr auto query = cat_array([] {
+    return cat("SELECT id, name FROM users WHERE id < ", table_size, " LIMIT ", 10u);
+});
+}  // namespace
+
+TEST_CASE("fixed_string") {
+    constexpr fixed_string s("abc");
+    static_assert(s.size() == 3);
+    static_assert(s.view() == "abc");
+    static_assert(s.c_str()[3] == '\0');
+    REQUIRE(std::string(s.c_str()) == "abc");
+    REQUIRE(cat(s, '!').build() == "abc!");
+}
+
+TEST_CASE("static_cat") {
+    static_assert(metric.view() == "http.status.404.count");
+    static_assert(metric.size() == 21);
+    static_assert(query.view() == "SELECT id, name FROM users WHERE id < 1000 LIMIT 10");
+    static_assert(static_cat<>().size() == 0);
+    static_assert(static_cat<true, ',', false>().view() == "1,0");
+    REQUIRE(metric.view() == "http.status.404.count");
+}
+
+TEST_CASE("static_cat integers") {
+    static_assert(static_cat<0>().view() == "0");
+    static_assert(static_cat<std::numeric_limits<std::int8_t>::min()>().view() == "-128");
+    static_assert(static_cat<std::numeric_limits<std::uint16_t>::max()>().view() == "65535");
+    static_assert(static_cat<std::numeric_limits<std::int32_t>::min()>().view() == "-2147483648");
+    static_assert(static_cat<std::numeric_limits<std::int64_t>::min()>().view() ==
+                  "-9223372036854775808");
+    static_assert(static_cat<std::numeric_limits<std::uint64_t>::max()>().view() ==
+                  "18446744073709551615");
+    // Every digit count, as at run time
+    constexpr auto powers = cat_array([] {
+        return cat(9u, ' ', 10u, ' ', 99999u, ' ', 100000u, ' ', 9999999999ull, ' ',
+                   10000000000ull);
+    });
+    static_assert(powers.view() == "9 10 99999 100000 9999999999 10000000000");
+}
+
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+TEST_CASE("static_cat floating point") {
+    static_assert(cat_array([] { return cat(0.1); }).view() == "0.1");
+    static_assert(cat_array([] { return cat(-1.5f, ' ', 1e21, ' ', 5e-324); }).view() ==
+                  "-1.5 1e+21 5e-324");
+    static_assert(cat_array([] { return cat(0.001, ' ', 0.0001, ' ', 1500000.0); }).view() ==
+                  "0.001 1e-04 1500000");
+    constexpr auto s = cat_array([] {
+        return cat(3.14159265358979323, ' ', std::numeric_limits<double>::max(), ' ',
+                   std::numeric_limits<float>::min(), ' ', 123456789012345680000.0);
+    });
+    REQUIRE(s.view() == cat(3.14159265358979323, ' ', std::numeric_limits<double>::max(), ' ',
+                            std::numeric_limits<float>::min(), ' ', 123456789012345680000.0)
+                            .build());
+}
+#endif
+
+TEST_CASE("static_cat units") {
+    static_assert(cat_array([] { return cat(grouped(-1234567), ' ', grouped(999u)); }).view() ==
+                  "-1,234,567 999");
+    static_assert(cat_array([] { return cat(bytes_iec(1023), ' ', bytes_iec(1048575)); }).view() ==
+                  "1023 B 1.0 MiB");
+#if defined(LAZYCAT_HAS_CONSTEXPR_FLOATING_POINT)
+    static_assert(
+        cat_array([] { return cat(si_units(4200), ' ', si_units(-0.0031, 2)); }).view() ==
+        "4.2k -3.10m");
+    // Rounding (ties to even), rounding up to the next prefix and the special values, as at run
+    // time
+    constexpr auto s = cat_array([] {
+        return cat(si_units(2.5, 0), ' ', si_units(1250), ' ', si_units(999.96), ' ',
+                   si_units(1.0 / 3, 15), ' ', si_units(1e30), ' ', si_units(-0.0), ' ',
+                   si_units(std::numeric_limits<double>::quiet_NaN()));
+    });
+    REQUIRE(s.view() == cat(si_units(2.5, 0), ' ', si_units(1250), ' ', si_units(999.96), ' ',
+                            si_units(1.0 / 3, 15), ' ', si_units(1e30), ' ', si_units(-0.0), ' ',
+                            si_units(std::numeric_limits<double>::quiet_NaN()))
+                            .build());
+    REQUIRE(s.view() == "2 1.2k 1.0k 333.333333333333314m 1e+30 -0.0 nan");
+#endif
+}
+
+TEST_CASE("cat_array wide") {
+    constexpr auto w = cat_array([] { return cat<wchar_t>(L"id=", 42, L' ', 'x'); });
+    static_assert(w.view() == L"id=42 x");
+    constexpr auto u = cat_array([] { return cat<char16_t>(u"é", -7); });
+    REQUIRE(std::u16string(u.view()) == u"é-7");
+    constexpr auto d = cat_array([] { return cat<char16_t>("caf\u00e9 \U0001F600"); });
+    static_assert(d.view() == u"caf\u00e9 \U0001F600");
+}
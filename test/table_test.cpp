@@ -0,0 +1,58 @@
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <lazycat/lazycat.hpp>
+#include <lazycat/lazycat_table.hpp>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace lazycat;
+
+TEST_CASE("format_table") {
+    const std::vector<std::int64_t> ids = {0, -1, std::numeric_limits<std::int64_t>::min(), 42};
+    const std::vector<double> prices = {1.5, 0.0, -2.25, 1e100};
+    const std::vector<std::string> names = {"a", "", "long name", "z"};
+    const std::array<bool, 4> flags = {true, false, false, true};
+    REQUIRE(format_table({}, ids, prices, names, flags) ==
+            "0,1.5,a,1\n"
+            "-1,0,,0\n"
+            "-9223372036854775808,-2.25,long name,0\n"
+            "42,1e+100,z,1\n");
+    REQUIRE(format_table({.separator = '\t', .line_end = "\r\n"}, names, ids) ==
+            "a\t0\r\n\t-1\r\nlong name\t-9223372036854775808\r\nz\t42\r\n");
+    REQUIRE(format_table({.separator = '|', .line_end = ""}, ids, names) ==
+            "0|a-1|-9223372036854775808|long name42|z");
+    // The shortest column decides the number of rows
+    REQUIRE(format_table({}, std::span(ids).first(2), names) == "0,a\n-1,\n");
+    REQUIRE(format_table({}, std::vector<int>{}, names).empty());
+    // Element types without a dedicated column type go through their writers
+    const std::vector<char> chars = {'x', 'y'};
+    const std::vector<const char*> c_strings = {"p", "q"};
+    const std::vector<std::uint8_t> bytes = {0, 255};
+    REQUIRE(format_table({.separator = ' '}, chars, c_strings, bytes) == "x p 0\ny q 255\n");
+}
+
+TEST_CASE("format_table matches cat() per row") {
+    constexpr size_t rows = 20000;  // several blocks, and several threads
+    std::vector<std::uint32_t> a(rows);
+    std::vector<std::int16_t> b(rows);
+    std::vector<std::string_view> c(rows);
+    std::vector<float> d(rows);
+    const std::string_view words[] = {"", "x", "hello", "a longer field"};
+    std::uint32_t state = 1;
+    for (size_t i = 0; i != rows; ++i) {
+        state = state * 1664525u + 1013904223u;
+        a[i] = state >> (state % 32);
+        b[i] = static_cast<std::int16_t>(state);
+        c[i] = words[state % 4];
+        d[i] = static_cast<float>(state) / 1000.0f;
+    }
+    std::string expected;
+    for (size_t i = 0; i != rows; ++i) expected += cat(a[i], ';', b[i], ';', c[i], ';', d[i], '\n');
+    for (unsigned threads : {0u, 1u, 3u, 8u}) {
+        REQUIRE(format_table({.separator = ';', .threads = threads}, a, b, c, d) == expected);
+    }
+}
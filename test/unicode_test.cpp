@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <lazycat/lazycat.hpp>
+#include <string>
+#include <string_view>
+
+using namespace lazycat;
+
+namespace {
+template <typename Writer>
+std::string write_all(const Writer& writer) {
+    std::string ret(writer.size(), '\0');
+    REQUIRE(writer.write(ret.data()) == ret.data() + ret.size());
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("utf8_from utf16") {
+    REQUIRE(write_all(utf8_from(u"")) == "");
+    REQUIRE(write_all(utf8_from(u"hello")) == "hello");
+    REQUIRE(write_all(utf8_from(u"héllo 世界")) == "h\xc3\xa9llo \xe4\xb8\x96\xe7\x95\x8c");
+    REQUIRE(write_all(utf8_from(u"\U0001F600")) == "\xf0\x9f\x98\x80");
+    // long enough to go through the vectorized paths, with a pair straddling a block boundary
+    REQUIRE(write_all(utf8_from(u"0123456\U0001F600abcdefghéijklmnop")) ==
+            "0123456\xf0\x9f\x98\x80"
+            "abcdefgh\xc3\xa9ijklmnop");
+    // lone surrogates
+    const char16_t lone[] = {u'a', 0xD800, u'b', 0xDC00, 0xD83D};
+    REQUIRE(write_all(utf8_from(std::u16string_view(lone, 5))) ==
+            "a\xef\xbf\xbd"
+            "b\xef\xbf\xbd\xef\xbf\xbd");
+}
+
+TEST_CASE("utf8_from utf32") {
+    REQUIRE(write_all(utf8_from(U"")) == "");
+    REQUIRE(write_all(utf8_from(U"abcdefghij")) == "abcdefghij");
+    REQUIRE(write_all(utf8_from(U"aé世\U0001F600bcdefgh")) ==
+            "a\xc3\xa9\xe4\xb8\x96\xf0\x9f\x98\x80"
+            "bcdefgh");
+    const char32_t invalid[] = {U'a', 0xD800, 0x110000, 0xFFFFFFFF, U'b', U'c', U'd', U'e'};
+    REQUIRE(write_all(utf8_from(std::u32string_view(invalid, 8))) ==
+            "a\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd"
+            "bcde");
+}
+
+TEST_CASE("validated_utf8") {
+    REQUIRE(write_all(validated_utf8("")) == "");
+    REQUIRE(write_all(validated_utf8("plain ascii text that is long")) ==
+            "plain ascii text that is long");
+    REQUIRE(write_all(validated_utf8("h\xc3\xa9llo \xf0\x9f\x98\x80")) ==
+            "h\xc3\xa9llo \xf0\x9f\x98\x80");
+    // stray continuation byte, overlong encoding, surrogate, truncated sequence
+    REQUIRE(write_all(validated_utf8("a\x80"
+                                     "b")) == "a\xef\xbf\xbd"
+                                             "b");
+    REQUIRE(write_all(validated_utf8("\xc0\xaf")) == "\xef\xbf\xbd\xef\xbf\xbd");
+    REQUIRE(write_all(validated_utf8("\xed\xa0\x80")) == "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd");
+    REQUIRE(write_all(validated_utf8("x\xe4\xb8")) == "x\xef\xbf\xbd");
+    REQUIRE(write_all(validated_utf8("\xf4\x90\x80\x80")) ==
+            "\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd\xef\xbf\xbd");
+}
+
+TEST_CASE("concat utf8_from") {
+    std::u16string name = u"世界";
+    REQUIRE(cat("hello ", utf8_from(name), '!').build() == "hello \xe4\xb8\x96\xe7\x95\x8c!");
+    REQUIRE(cat<char8_t>(utf8_from(U"é"), validated_utf8("\xff")).build() ==
+            u8"é�");
+    std::string s = "log: ";
+    append(s, utf8_from(L"wide")).build();
+    REQUIRE(s == "log: wide");
+}
@@ -70,3 +70,61 @@ TEST_CASE("append char") {
         REQUIRE(copy == initial + ch + 'z');
     }
 }
+
+TEST_CASE("concat wide strings") {
+    std::wstring w1 = L"wide1";
+    std::u16string u1 = u"utf16";
+    std::u32string u2 = U"utf32";
+    std::u8string u3 = u8"utf8";
+    REQUIRE(cat<wchar_t>(w1, L'!').build() == L"wide1!");
+    REQUIRE(cat<char16_t>(u1, u'-', u1).build() == u"utf16-utf16");
+    REQUIRE(cat<char32_t>(u2).build() == U"utf32");
+    REQUIRE(cat<char8_t>(u3, u8'.').build() == u8"utf8.");
+    std::wstring w2 = cat<wchar_t>(w1);
+    REQUIRE(w2 == w1);
+}
+
+TEST_CASE("concat narrow strings into wide strings") {
+    // long enough to exercise the vectorized widening loop
+    std::string s1 = "abcdefghijklmnopqrstuvwxyz0123456789";
+    REQUIRE(cat<wchar_t>(s1, 'x', L"y").build() == L"abcdefghijklmnopqrstuvwxyz0123456789xy");
+    REQUIRE(cat<char16_t>("key=", s1).build() == u"key=abcdefghijklmnopqrstuvwxyz0123456789");
+    REQUIRE(cat<char32_t>(s1, U'!').build() == U"abcdefghijklmnopqrstuvwxyz0123456789!");
+    REQUIRE(cat<char8_t>(s1).build() == u8"abcdefghijklmnopqrstuvwxyz0123456789");
+}
+
+TEST_CASE("concat UTF-8 strings into wide strings") {
+    REQUIRE(cat<char16_t>("é").build() == u"é");
+    REQUIRE(cat<wchar_t>(std::string("na\u00efve caf\u00e9")).build() == L"na\u00efve caf\u00e9");
+    REQUIRE(cat<char32_t>("\u20ac", 5).build() == U"\u20ac5");
+    REQUIRE(cat<char16_t>("\U0001F600").build() == u"\U0001F600");  // a surrogate pair
+    REQUIRE(cat<char32_t>("\U0001F600").build() == U"\U0001F600");
+    REQUIRE(cat<char16_t>(u8"\u00e9t\u00e9").build() == u"\u00e9t\u00e9");
+    // non-ASCII after the vectorized ASCII prefix, and ASCII after it
+    const std::string mixed = "0123456789abcdef0123\u00e9456789abcdef0123456789abcdef\U0001F600";
+    REQUIRE(cat<char16_t>(mixed).build() ==
+            u"0123456789abcdef0123\u00e9456789abcdef0123456789abcdef\U0001F600");
+    std::u16string appended = u"x=";
+    append(appended, "\u00e9", 1).build();
+    REQUIRE(appended == u"x=\u00e91");
+}
+
+TEST_CASE("malformed UTF-8 is replaced when widening") {
+    // each maximal invalid subpart is one U+FFFD
+    REQUIRE(cat<char16_t>("\xe9").build() == u"\ufffd");
+    REQUIRE(cat<char32_t>("a\xe2\x82z\xff").build() == U"a\ufffdz\ufffd");
+    REQUIRE(cat<char16_t>("\xed\xa0\x80").build() == u"\ufffd\ufffd\ufffd");  // surrogate
+    // a single narrow char, or narrow content that cannot be decoded (a nested narrow catter),
+    // is never zero-extended as Latin-1
+    REQUIRE(cat<char16_t>('\xe9', 'x').build() == u"\ufffdx");
+    REQUIRE(cat<char32_t>(cat("\u00e9", 1)).build() == U"\ufffd\ufffd1");
+}
+
+TEST_CASE("append wide strings") {
+    std::wstring initial = L"initial";
+    append(initial, L"-", std::string("narrow"), L'!').build();
+    REQUIRE(initial == L"initial-narrow!");
+    std::u16string initial16 = u"initial";
+    (append(initial16) << u"x" << 'y').build();
+    REQUIRE(initial16 == u"initialxy");
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <lazycat/lazycat.hpp>
+#include <limits>
+#include <string>
+
+using namespace lazycat;
+
+namespace {
+template <typename Writer>
+std::string checked(const Writer& writer) {
+    std::string ret = cat(writer);
+    REQUIRE(writer.size() == ret.size());
+    return ret;
+}
+}  // namespace
+
+TEST_CASE("grouped") {
+    REQUIRE(checked(grouped(0)) == "0");
+    REQUIRE(checked(grouped(999)) == "999");
+    REQUIRE(checked(grouped(1000)) == "1,000");
+    REQUIRE(checked(grouped(1234567)) == "1,234,567");
+    REQUIRE(checked(grouped(-1234567)) == "-1,234,567");
+    REQUIRE(checked(grouped(-100)) == "-100");
+    REQUIRE(checked(grouped(123456, '\'')) == "123'456");
+    REQUIRE(checked(grouped(std::numeric_limits<std::int64_t>::min())) ==
+            "-9,223,372,036,854,775,808");
+    REQUIRE(checked(grouped(std::numeric_limits<std::uint64_t>::max(), ' ')) ==
+            "18 446 744 073 709 551 615");
+    REQUIRE(checked(grouped(std::uint8_t{255})) == "255");
+    REQUIRE(cat<wchar_t>(grouped(1234)).build() == L"1,234");
+}
+
+TEST_CASE("bytes_iec") {
+    REQUIRE(checked(bytes_iec(0)) == "0 B");
+    REQUIRE(checked(bytes_iec(1023)) == "1023 B");
+    REQUIRE(checked(bytes_iec(1024)) == "1.0 KiB");
+    REQUIRE(checked(bytes_iec(1536)) == "1.5 KiB");
+    REQUIRE(checked(bytes_iec(12900000)) == "12.3 MiB");
+    REQUIRE(checked(bytes_iec(1048575)) == "1.0 MiB");  // 1023.999 KiB rounds up to the next unit
+    REQUIRE(checked(bytes_iec(1048000)) == "1023.4 KiB");
+    REQUIRE(checked(bytes_iec(std::uint64_t{5} << 40)) == "5.0 TiB");
+    REQUIRE(checked(bytes_iec(std::numeric_limits<std::uint64_t>::max())) == "16.0 EiB");
+    REQUIRE(cat<char16_t>(bytes_iec(2048)).build() == u"2.0 KiB");
+}
+
+TEST_CASE("si_units") {
+    REQUIRE(checked(si_units(0)) == "0.0");
+    REQUIRE(checked(si_units(4200)) == "4.2k");
+    REQUIRE(checked(si_units(4200, 0)) == "4k");
+    REQUIRE(checked(si_units(12.5)) == "12.5");
+    REQUIRE(checked(si_units(999.96)) == "1.0k");  // rounds up to the next prefix
+    REQUIRE(checked(si_units(1234567, 2)) == "1.23M");
+    REQUIRE(checked(si_units(-4.2e9)) == "-4.2G");
+    REQUIRE(checked(si_units(0.0031)) == "3.1m");
+    REQUIRE(checked(si_units(2.5e-6)) == "2.5u");
+    REQUIRE(checked(si_units(1e24)) == "1.0Y");
+    REQUIRE(checked(si_units(1e30)) == "1e+30");
+    REQUIRE(checked(si_units(std::numeric_limits<double>::infinity())) == "inf");
+    REQUIRE(cat<wchar_t>(si_units(4200), L" req/s").build() == L"4.2k req/s");
+}